@@ -40,10 +40,13 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 f8c -- compile FIX xml schema\n
 \n
 <tt>
-Usage: f8c [-NVcdfhiknoprstvx] \<input xml schema\>\n
+Usage: f8c [-FNVcdfhiknoprstvx] \<input xml schema\>\n
    -N,--nounique           do not enforce unique field parsing (default false)\n
    -V,--verbose            be more verbose when processing\n
    -c,--classes \<server|client\> generate user session classes (default no)\n
+   -F,--fixedpoint \<types\> comma separated float types (e.g. PRICE,QTY,AMT,PRICEOFFSET or ALL) to generate as fixed point Decimal\n
+   -I,--intern \<fields\>  comma separated string fields (or NONE) to intern, with any marked intern="Y" in the schema\n
+                           (default Currency,SenderSubID,TargetSubID,ExDestination,OnBehalfOfCompID,DeliverToCompID,SecurityExchange)\n
    -f,--fields             generate code for all defined fields even if they are not used in any message (default no)\n
    -d,--dump               dump 1st pass parsed source xml file, exit\n
    -h,--help               help, this screen\n
@@ -111,11 +114,12 @@ namespace FIX8
 const string Ctxt::_exts[count] = { "_types.cpp", "_types.hpp", "_traits.cpp", "_classes.cpp",
 	"_classes.hpp", "_router.hpp", "_session.hpp" };
 
-string precompFile, spacer, inputFile, shortName, fixt, shortNameFixt, odir("./"), prefix("Myfix"), gen_classes;
-bool verbose(false), error_ignore(false), gen_fields(false);
+string precompFile, spacer, inputFile, shortName, fixt, shortNameFixt, odir("./"), prefix("Myfix"), gen_classes, fixed_point, gen_encoders,
+	intern_fields("Currency,SenderSubID,TargetSubID,ExDestination,OnBehalfOfCompID,DeliverToCompID,SecurityExchange");
+bool verbose(false), error_ignore(false), gen_fields(false), gen_decoders(false);
 unsigned glob_errors(0), glob_warnings(0), tabsize(3);
 extern unsigned glob_errors;
-extern const string GETARGLIST("hvVo:p:dikn:rst:x:Nc:fb");
+extern const string GETARGLIST("hvVo:p:dikn:rst:x:Nc:fbF:DE:I:");
 extern string spacer, shortName;
 
 //-----------------------------------------------------------------------------------------
@@ -148,6 +152,9 @@ int precomp(XmlElement& xf, ostream& outf);
 int precompfixt(XmlElement& xft, XmlElement& xf, ostream& outf, bool nounique);
 void generate_group_bodies(const MessageSpec& ms, const FieldSpecMap& fspec, int depth,
 	const string& msname, ostream& outp, ostream& outh, const string cls_prefix=string());
+void generate_decoder(const MessageSpec& ms, const FieldSpecMap& fspec, const Ctxt& ctxt, ostream& outp);
+void generate_encoder(const MessageSpec& ms, const FieldSpecMap& fspec, const Ctxt& ctxt, ostream& outp);
+bool find_msg_hash(const vector<unsigned>& keys, unsigned& mult, unsigned& bits);
 void binary_report();
 
 //-----------------------------------------------------------------------------------------
@@ -177,6 +184,10 @@ int main(int argc, char **argv)
 		{ "namespace",		1,	0,	'n' },
 		{ "tabsize",		1,	0,	't' },
 		{ "fixt",			1,	0,	'x' },
+		{ "fixedpoint",	1,	0,	'F' },
+		{ "decoders",		0,	0,	'D' },
+		{ "encoders",		1,	0,	'E' },
+		{ "intern",			1,	0,	'I' },
 		{ 0 },
 	};
 
@@ -210,6 +221,10 @@ int main(int argc, char **argv)
 		case 'b': binary_report(); return 0;
 		case 'x': fixt = optarg; break;
 		case 'n': ctxt._fixns = optarg; break;
+		case 'F': fixed_point = optarg; break;
+		case 'D': gen_decoders = true; break;
+		case 'E': gen_encoders = optarg; break;
+		case 'I': intern_fields = optarg; break;
 		default: break;
 		}
 	}
@@ -385,6 +400,8 @@ int load_fields(XmlElement& xf, FieldSpecMap& fspec)
 
 			(*itr)->GetAttr("description", result.first->second._description);
 			(*itr)->GetAttr("comment", result.first->second._comment);
+			string intern;
+			result.first->second._intern = (*itr)->GetAttr("intern", intern) && intern == "Y";
 
 			++fieldsLoaded;
 
@@ -667,6 +684,137 @@ void generate_group_bodies(const MessageSpec& ms, const FieldSpecMap& fspec, int
 	}
 }
 
+//-----------------------------------------------------------------------------------------
+void generate_decoder(const MessageSpec& ms, const FieldSpecMap& fspec, const Ctxt& ctxt, ostream& outp)
+{
+	const Presence& pr(ms._fields.get_presence());
+	const bool masked(pr.size() <= 64);
+	unsigned long long mandatory(masked ? 0 : ~0ULL);
+	for (Presence::const_iterator flitr(pr.begin()); masked && flitr != pr.end(); ++flitr)
+		if (flitr->_field_traits.has(FieldTrait::mandatory))
+			mandatory |= 1ULL << Presence::distance(pr.begin(), flitr);
+
+	outp << _csMap.find_ref(cs_divider) << endl;
+	outp << "bool " << ms._name << "::decode_specialised(const char *from, const unsigned sz, unsigned& offset, FieldIndex *idx)" << endl;
+	outp << '{' << endl;
+	outp << spacer << "if (_fp.size() != " << pr.size() << ")	// custom fields added; trait indices differ" << endl;
+	outp << spacer << spacer << "return false;" << endl;
+	ostringstream mstr;
+	mstr << "0x" << hex << mandatory << "ULL";
+	outp << spacer << "const unsigned long long mandatory(" << mstr.str() << ");" << endl;
+	outp << spacer << "unsigned long long seen(0);" << endl;
+	outp << spacer << "unsigned s_offset(offset), result, tv, vlen;" << endl;
+	outp << spacer << "const char *val;" << endl;
+	outp << spacer << "const Presence::const_iterator trt(_fp.get_presence().begin());" << endl << endl;
+	outp << spacer << "while (s_offset <= sz && (result = idx ? idx->extract(s_offset, tv, val, vlen)" << endl;
+	outp << spacer << spacer << ": extract_element(from + s_offset, sz - s_offset, tv, val, vlen)))" << endl;
+	outp << spacer << '{' << endl;
+	outp << spacer << spacer << "switch (tv)" << endl;
+	outp << spacer << spacer << '{' << endl;
+
+	const string s3(spacer + spacer + spacer), s4(s3 + spacer);
+	for (Presence::const_iterator flitr(pr.begin()); flitr != pr.end(); ++flitr)
+	{
+		FieldSpecMap::const_iterator fs(fspec.find(flitr->_fnum));
+		const unsigned ti(Presence::distance(pr.begin(), flitr));
+		const bool isgroup(flitr->_field_traits.has(FieldTrait::group));
+		outp << spacer << spacer << "case " << flitr->_fnum << ":	// " << fs->second._name << endl;
+		outp << s3 << "s_offset += result;" << endl;
+		outp << s3 << "if (!decoded_present(" << flitr->_fnum << ", trt + " << ti << "))" << endl;
+		if (isgroup || fs->second._dvals)
+			outp << s3 << '{' << endl;
+		const string& ind(isgroup || fs->second._dvals ? s4 : s3);
+		if (fs->second._dvals)
+			outp << s4 << "static const RealmBase *rlm(_ctx._be.find_ref(" << flitr->_fnum << ")._rlm);" << endl;
+		outp << ind << "add_field(" << flitr->_fnum << ", trt + " << ti << ", " << flitr->_pos << ", new "
+			<< ctxt._fixns << "::" << fs->second._name << "(val, vlen" << (fs->second._dvals ? ", rlm" : "") << "), false);" << endl;
+		if (isgroup)
+			outp << s4 << "s_offset = decode_group(" << flitr->_fnum << ", from, sz, s_offset, idx);" << endl;
+		if (isgroup || fs->second._dvals)
+			outp << s3 << '}' << endl;
+		if (masked)
+			outp << s3 << "seen |= 1ULL << " << ti << ';' << endl;
+		outp << s3 << "break;" << endl;
+	}
+
+	outp << spacer << spacer << "default:" << endl;
+	outp << s3 << "offset = s_offset;" << endl;
+	outp << s3 << "return decoded_end(tv, seen, mandatory);" << endl;
+	outp << spacer << spacer << '}' << endl;
+	outp << spacer << '}' << endl << endl;
+	outp << spacer << "offset = s_offset;" << endl;
+	outp << spacer << "return decoded_end(0, seen, mandatory);" << endl;
+	outp << '}' << endl << endl;
+}
+
+//-----------------------------------------------------------------------------------------
+void generate_encoder(const MessageSpec& ms, const FieldSpecMap& fspec, const Ctxt& ctxt, ostream& outp)
+{
+	const Presence& pr(ms._fields.get_presence());
+	FieldTraitOrder mo;
+	for (Presence::const_iterator flitr(pr.begin()); flitr != pr.end(); ++flitr)
+		mo.insert(FieldTraitOrder::value_type(&*flitr));
+
+	outp << _csMap.find_ref(cs_divider) << endl;
+	outp << "bool " << ms._name << "::encode_specialised(char *to, size_t& sz) const" << endl;
+	outp << '{' << endl;
+	outp << spacer << "if (_fp.size() != " << pr.size() << ")	// custom fields added; trait indices differ" << endl;
+	outp << spacer << spacer << "return false;" << endl;
+	outp << spacer << "const BaseField *fld;" << endl;
+
+	for (FieldTraitOrder::const_iterator fto(mo.begin()); fto != mo.end(); ++fto)
+	{
+		FieldSpecMap::const_iterator fs(fspec.find((*fto)->_fnum));
+		const string ftype(ctxt._fixns + "::" + fs->second._name);
+		ostringstream pfx;
+		pfx << (*fto)->_fnum << '=';
+		outp << spacer << "if ((fld = _fields[" << ((*fto)->_pos - 1) << "]) && !_fp.is_suppressed(" << Presence::distance(pr.begin(), *fto)
+			<< "))" << endl;
+		outp << spacer << '{' << endl;
+		outp << spacer << spacer << "::memcpy(to + sz, \"" << pfx.str() << "\", " << pfx.str().size() << ");" << endl;
+		outp << spacer << spacer << "sz += " << pfx.str().size() << ';' << endl;
+		outp << spacer << spacer << "static_cast<const " << ftype << " *>(fld)->" << ftype << "::print(to + sz, sz);" << endl;
+		outp << spacer << spacer << "*(to + sz++) = default_field_separator;" << endl;
+		if ((*fto)->_field_traits.has(FieldTrait::group))
+			outp << spacer << spacer << "encode_group(" << (*fto)->_fnum << ", to, sz);" << endl;
+		outp << spacer << '}' << endl;
+	}
+
+	outp << spacer << "return true;" << endl;
+	outp << '}' << endl << endl;
+}
+
+//-----------------------------------------------------------------------------------------
+bool find_msg_hash(const vector<unsigned>& keys, unsigned& mult, unsigned& bits)
+{
+	unsigned minbits(1);
+	while ((1U << minbits) < keys.size())
+		++minbits;
+
+	for (bits = minbits; bits <= 16; ++bits)
+	{
+		const unsigned shift(32 - bits);
+		unsigned seed(0x9e3779b9);
+		for (unsigned tries(0); tries < 100000; ++tries)
+		{
+			seed = seed * 1664525 + 1013904223;	// simple lcg; any odd multiplier will do
+			mult = seed | 1;
+			vector<bool> used(1 << bits);
+			vector<unsigned>::const_iterator itr(keys.begin());
+			for (; itr != keys.end(); ++itr)
+			{
+				const unsigned slot((*itr * mult) >> shift);
+				if (used[slot])
+					break;
+				used[slot] = true;
+			}
+			if (itr == keys.end())
+				return true;
+		}
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------------------
 int process(XmlElement& xf, Ctxt& ctxt)
 {
@@ -703,6 +851,30 @@ int process(XmlElement& xf, Ctxt& ctxt)
 
 	process_ordering(mspec);
 
+	// messages to generate specialised encoders for
+	set<string> encoded;
+	if (!gen_encoders.empty())
+	{
+		istringstream istr(gen_encoders);
+		for (string mname; getline(istr, mname, ',');)
+		{
+			bool found(false);
+			for (MessageSpecMap::const_iterator mitr(mspec.begin()); mitr != mspec.end(); ++mitr)
+			{
+				if (mname == "ALL" || mname == mitr->second._name)
+				{
+					encoded.insert(mitr->second._name);
+					found = true;
+				}
+			}
+			if (!found)
+			{
+				cerr << "Error: " << mname << " not a known message, cannot generate encoder." << endl;
+				++glob_errors;
+			}
+		}
+	}
+
 	// output file preambles
 	generate_preamble(osu_hpp);
 	osu_hpp << "#ifndef _" << flname(ctxt._out[Ctxt::router_hpp].first.second) << '_' << endl;
@@ -797,6 +969,11 @@ int process(XmlElement& xf, Ctxt& ctxt)
 			osc_hpp << spacer << "static const FieldTrait_Hash_Array _ftha;" << endl;
 #endif
 			osc_hpp << spacer << "static const MsgType _msgtype;" << endl;
+			if (gen_decoders)
+				osc_hpp << endl << spacer
+					<< "bool decode_specialised(const char *from, const unsigned sz, unsigned& offset, FieldIndex *idx);" << endl;
+			if (encoded.count(mitr->second._name))
+				osc_hpp << spacer << "bool encode_specialised(char *to, size_t& sz) const;" << endl;
 		}
 
 		osc_hpp << endl;
@@ -864,6 +1041,84 @@ int process(XmlElement& xf, Ctxt& ctxt)
 	osc_cpp << endl;
 	osc_cpp << "const " << ctxt._clname << "_BaseMsgEntry bme;" << endl;
 	osc_cpp << "const " << ctxt._clname << "_BaseEntry be;" << endl;
+
+	// pre-rendered "NNN=" encode prefixes, indexed by tag
+	unsigned maxtag(0);
+	for (FieldSpecMap::const_iterator fitr(fspec.begin()); fitr != fspec.end(); ++fitr)
+		if ((gen_fields || fitr->second._used) && fitr->first > maxtag)
+			maxtag = fitr->first;
+	osc_cpp << endl << "const TagPrefix tag_prefix[] =" << endl << '{';
+	for (unsigned tag(0); tag <= maxtag; ++tag)
+	{
+		if (tag)
+			osc_cpp << ',';
+		if (tag % 8 == 0)
+			osc_cpp << endl << spacer;
+		else
+			osc_cpp << ' ';
+		FieldSpecMap::const_iterator fitr(fspec.find(tag));
+		if (fitr != fspec.end() && (gen_fields || fitr->second._used))
+		{
+			ostringstream ostr;
+			ostr << tag << '=';
+			osc_cpp << "{ " << ostr.str().size() << ", \"" << ostr.str() << "\" }";
+		}
+		else
+			osc_cpp << "{ 0, \"\" }";
+	}
+	osc_cpp << endl << "};" << endl;
+
+	// field table index, by tag
+	osc_cpp << endl << "const unsigned short fld_index[] =" << endl << '{';
+	for (unsigned tag(0), idx(0); tag <= maxtag; ++tag)
+	{
+		if (tag)
+			osc_cpp << ',';
+		if (tag % 16 == 0)
+			osc_cpp << endl << spacer;
+		else
+			osc_cpp << ' ';
+		FieldSpecMap::const_iterator fitr(fspec.find(tag));
+		osc_cpp << (fitr != fspec.end() && (gen_fields || fitr->second._used) ? ++idx : 0);
+	}
+	osc_cpp << endl << "};" << endl;
+
+	// perfect hash of message types to message table index
+	vector<unsigned> mkeys, mslots;
+	for (MessageSpecMap::const_iterator mitr(mspec.begin()); mitr != mspec.end(); ++mitr)
+		if (mitr->first.size() <= 4)
+			mkeys.push_back(MetaHash::msg_key(mitr->first.data(), mitr->first.size()));
+	unsigned mult(0), bits(0);
+	if (!find_msg_hash(mkeys, mult, bits))
+	{
+		cerr << "Error: could not generate message type hash" << endl;
+		++glob_errors;
+	}
+	else
+	{
+		mslots.resize(1 << bits);
+		unsigned idx(0);
+		for (MessageSpecMap::const_iterator mitr(mspec.begin()); mitr != mspec.end(); ++mitr)
+		{
+			++idx;
+			if (mitr->first.size() <= 4)
+				mslots[(MetaHash::msg_key(mitr->first.data(), mitr->first.size()) * mult) >> (32 - bits)] = idx;
+		}
+	}
+	osc_cpp << endl << "const unsigned short msg_slots[] =" << endl << '{';
+	for (unsigned slot(0); slot < mslots.size(); ++slot)
+	{
+		if (slot)
+			osc_cpp << ',';
+		if (slot % 16 == 0)
+			osc_cpp << endl << spacer;
+		else
+			osc_cpp << ' ';
+		osc_cpp << mslots[slot];
+	}
+	osc_cpp << endl << "};" << endl;
+	osc_cpp << endl << "const MetaHash meta_hash = { 0x" << hex << mult << dec << ", " << (32 - bits)
+		<< ", msg_slots, fld_index, sizeof(fld_index)/sizeof(unsigned short) };" << endl;
 	osc_cpp << endl << _csMap.find_ref(cs_end_anon_namespace) << endl;
 	osc_cpp << endl << "} // namespace " << ctxt._fixns << endl;
 
@@ -888,7 +1143,24 @@ int process(XmlElement& xf, Ctxt& ctxt)
 		<< ctxt._clname << "_BaseMsgEntry::Pair));" << endl;
 	osc_cpp << "template<>" << endl << "const " << ctxt._fixns << "::" << ctxt._clname << "_BaseMsgEntry::NotFoundType "
 		<< ctxt._fixns << "::" << ctxt._clname << "_BaseMsgEntry::_noval = {0, 0};" << endl;
-	osc_cpp << "namespace " << ctxt._fixns << " { F8MetaCntx ctx(" << ctxt._version << ", bme, be, \"" << ctxt._beginstr << "\"); }" << endl;
+	osc_cpp << "namespace " << ctxt._fixns << " { F8MetaCntx ctx(" << ctxt._version << ", bme, be, \"" << ctxt._beginstr << "\"," << endl
+		<< spacer << "tag_prefix, sizeof(tag_prefix)/sizeof(TagPrefix), &meta_hash); }" << endl;
+
+	// specialised per message decoders and encoders
+	if (gen_decoders || !encoded.empty())
+	{
+		osc_cpp << endl << "namespace " << ctxt._fixns << " {" << endl << endl;
+		for (MessageSpecMap::const_iterator mitr(mspec.begin()); mitr != mspec.end(); ++mitr)
+		{
+			if (!mitr->second._fields.get_presence().size())
+				continue;
+			if (gen_decoders)
+				generate_decoder(mitr->second, fspec, ctxt, osc_cpp);
+			if (encoded.count(mitr->second._name))
+				generate_encoder(mitr->second, fspec, ctxt, osc_cpp);
+		}
+		osc_cpp << "} // namespace " << ctxt._fixns << endl;
+	}
 
 // ==================================== Message router ==================================
 
@@ -1004,6 +1276,40 @@ int process(XmlElement& xf, Ctxt& ctxt)
 	ost_hpp << "#ifndef _" << flname(ctxt._out[Ctxt::types_hpp].first.second) << '_' << endl;
 	ost_hpp << "#define _" << flname(ctxt._out[Ctxt::types_hpp].first.second) << '_' << endl << endl;
 	ost_hpp << _csMap.find_ref(cs_start_namespace) << endl;
+
+	// string fields to intern: those named with -I and those marked intern="Y" in the schema
+	if (intern_fields != "NONE")
+	{
+		istringstream istr(intern_fields);
+		for (string fname; getline(istr, fname, ',');)
+		{
+			FieldToNumMap::const_iterator nitr(ftonSpec.find(fname));
+			if (nitr != ftonSpec.end())
+				fspec.find(nitr->second)->second._intern = true;
+			else
+			{
+				cerr << "Warning: " << fname << " not a field in " << shortName << ", cannot intern." << endl;
+				++glob_warnings;
+			}
+		}
+	}
+	for (FieldSpecMap::const_iterator fitr(fspec.begin()); fitr != fspec.end(); ++fitr)
+	{
+		if (!fitr->second._intern || (!gen_fields && !fitr->second._used))
+			continue;
+		const FieldTrait::FieldType ftype(fitr->second._ftype);	// the time types are the only strings not held as f8String
+		if (!FieldTrait::is_string(ftype) || (ftype >= FieldTrait::ft_UTCTimestamp && ftype <= FieldTrait::ft_TZTimestamp))
+		{
+			cerr << "Warning: " << fitr->second._name << " is not a string field, cannot intern." << endl;
+			++glob_warnings;
+			continue;
+		}
+		// several generated codecs may share a program; the first to select a tag specialises it
+		ost_hpp << "#if !defined FIX8_INTERN_" << fitr->first << endl << "#define FIX8_INTERN_" << fitr->first << endl;
+		ost_hpp << "template<> struct InternField<" << fitr->first << "> { enum { value = true }; };\t// "
+			<< fitr->second._name << endl << "#endif" << endl;
+	}
+
 	ost_hpp << "namespace " << ctxt._fixns << " {" << endl;
 
 	ost_hpp << endl << _csMap.find_ref(cs_divider) << endl;
@@ -1016,6 +1322,32 @@ int process(XmlElement& xf, Ctxt& ctxt)
 
 	ost_cpp << _csMap.find_ref(cs_start_anon_namespace) << endl;
 	ost_cpp << endl << _csMap.find_ref(cs_divider) << endl;
+	// float types to generate as fixed point Decimal
+	set<FieldTrait::FieldType> fixed_types;
+	if (!fixed_point.empty())
+	{
+		string types(fixed_point);
+		transform(types.begin(), types.end(), types.begin(), ::toupper);
+		istringstream istr(types);
+		for (string tname; getline(istr, tname, ',');)
+		{
+			if (tname == "ALL")
+			{
+				for (int ftype(FieldTrait::ft_float); ftype <= FieldTrait::ft_end_float; ++ftype)
+					fixed_types.insert(static_cast<FieldTrait::FieldType>(ftype));
+				continue;
+			}
+			const FieldTrait::FieldType ftype(FieldSpec::_baseTypeMap.find_value(tname));
+			if (!FieldTrait::is_float(ftype))
+			{
+				cerr << "Error: " << tname << " not a float type, cannot generate as fixed point." << endl;
+				++glob_errors;
+				continue;
+			}
+			fixed_types.insert(ftype);
+		}
+	}
+
 	// generate field types
 	for (FieldSpecMap::const_iterator fitr(fspec.begin()); fitr != fspec.end(); ++fitr)
 	{
@@ -1023,7 +1355,7 @@ int process(XmlElement& xf, Ctxt& ctxt)
 			continue;
 		if (!fitr->second._comment.empty())
 			ost_hpp << "// " << fitr->second._comment << endl;
-		ost_hpp << "typedef Field<" << FieldSpec::_typeToCPP.find_ref(fitr->second._ftype)
+		ost_hpp << "typedef Field<" << (fixed_types.count(fitr->second._ftype) ? "Decimal" : FieldSpec::_typeToCPP.find_ref(fitr->second._ftype))
 			<< ", " << fitr->first << "> " << fitr->second._name << ';' << endl;
 		if (fitr->second._dvals)
 			process_value_enums(fitr, ost_hpp, ost_cpp);
@@ -1052,12 +1384,12 @@ int process(XmlElement& xf, Ctxt& ctxt)
 	{
 		if (!gen_fields && !fitr->second._used)
 			continue;
-		ost_cpp << "BaseField *Create_" << fitr->second._name << "(const f8String& from, const RealmBase *db, const int rv)";
+		ost_cpp << "BaseField *Create_" << fitr->second._name << "(const char *from, const size_t sz, const RealmBase *db, const int rv)";
 		ost_cpp << " // " << fitr->second._name << endl;
 		if (fitr->second._dvals) // generate code to create a Field using a value taken from an index into a Realm
 		{
 			ost_cpp << spacer << "{ return !db || rv < 0 || rv >= db->_sz || db->_dtype != RealmBase::dt_set ? new "
-				<< fitr->second._name << "(from, db) : new " << fitr->second._name << "(db->get_rlm_val<";
+				<< fitr->second._name << "(from, sz, db) : new " << fitr->second._name << "(db->get_rlm_val<";
 			if (FieldTrait::is_int(fitr->second._ftype))
 				ost_cpp << "int";
 			else if (FieldTrait::is_char(fitr->second._ftype))
@@ -1075,7 +1407,7 @@ int process(XmlElement& xf, Ctxt& ctxt)
 			ost_cpp << ">(rv), db); }" << endl;
 		}
 		else
-			ost_cpp << spacer << "{ return new " << fitr->second._name << "(from, db); }" << endl;
+			ost_cpp << spacer << "{ return new " << fitr->second._name << "(from, sz, db); }" << endl;
 	}
 
 	ost_cpp << endl << _csMap.find_ref(cs_end_anon_namespace) << endl;
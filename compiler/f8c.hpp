@@ -136,9 +136,11 @@ struct FieldSpec
 	RealmMap *_dvals;
 
 	mutable bool _used;
+	/// values of this field are held in the StringIntern table (intern="Y" in the schema, or named with -I)
+	bool _intern;
 
 	FieldSpec(const std::string& name, FieldTrait::FieldType ftype=FieldTrait::ft_untyped)
-		: _name(name), _ftype(ftype), _dtype(RealmBase::dt_set), _doffset(), _dvals(), _used() {}
+		: _name(name), _ftype(ftype), _dtype(RealmBase::dt_set), _doffset(), _dvals(), _used(), _intern() {}
 
 	virtual ~FieldSpec()
 	{
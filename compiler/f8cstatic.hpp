@@ -165,8 +165,11 @@ const CSMap::TypePair CSMap::_valueTable[] =
 "#include <mpmc.hpp>\n"
 "#include <f8utils.hpp>\n"
 "#include <f8types.hpp>\n"
+"#include <tickval.hpp>\n"
+"#include <frame.hpp>\n"
 "#include <traits.hpp>\n"
 "#include <field.hpp>\n"
+"#include <tokenizer.hpp>\n"
 "#include <message.hpp>"),
 	CSMap::TypePair(cs_divider,
 "//-------------------------------------------------------------------------------------------------"),
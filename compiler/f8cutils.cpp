@@ -344,6 +344,10 @@ void print_usage()
 	um.add('r', "retain", "retain 1st pass code (default delete)");
 	um.add('b', "binary", "print binary/ABI details, exit");
 	um.add('c', "classes <server|client>", "generate user session classes (default no)");
+	um.add('D', "decoders", "generate specialised decoders for each message (default no)");
+	um.add('E', "encoders <messages>", "comma separated message names (e.g. NewOrderSingle,ExecutionReport or ALL) to generate specialised encoders for (default none)");
+	um.add('I', "intern <fields>", "comma separated string fields (or NONE) to intern, with any marked intern=\"Y\" in the schema (default Currency,SenderSubID,TargetSubID,ExDestination,OnBehalfOfCompID,DeliverToCompID,SecurityExchange)");
+	um.add('F', "fixedpoint <types>", "comma separated float types (e.g. PRICE,QTY,AMT,PRICEOFFSET or ALL) to generate as fixed point Decimal (default none)");
 	um.add('t', "tabwidth", "tabwidth for generated code (default 3 spaces)");
 	um.add('x', "fixt <file>", "For FIXT hosted transports or for FIX5.0 and above, the input FIXT schema file");
 	um.add('V', "verbose", "be more verbose when processing");
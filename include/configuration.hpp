@@ -215,12 +215,67 @@ public:
 	bool get_pipelined(const XmlElement *from)
 		{ return from && from->FindAttr("pipelined", true); }
 
+	/*! Extract the reactor flag.
+	  \param from xml entity to search
+	  \return true if reactor flag was passed and was true */
+	bool get_reactor(const XmlElement *from)
+		{ return from && from->FindAttr("reactor", false); }
+
+	/*! Extract the number of reactor threads. The first session to start the reactor sets this for the process.
+	  \param from xml entity to search
+	  \param def default value if not found
+	  \return the number of reactor threads or 1 if not found */
+	unsigned get_reactor_threads(const XmlElement *from, const unsigned def=Reactor::default_threads) const
+		{ if (from) return from->FindAttr("reactor_threads", def); return def; }
+
+	/*! Extract the maximum number of outbound frames sent with one write.
+	  \param from xml entity to search
+	  \param def default value if not found
+	  \return the maximum frames per write or 32 if not found; 1 disables batching */
+	unsigned get_write_batch(const XmlElement *from, const unsigned def=FIXWriter::default_batch_frames) const
+		{ if (from) return from->FindAttr("write_batch", def); return def; }
+
+	/*! Extract the maximum time (us) an outbound frame may wait in a batch.
+	  \param from xml entity to search
+	  \param def default value if not found
+	  \return the maximum batch latency or 1000 if not found */
+	unsigned get_write_batch_us(const XmlElement *from, const unsigned def=FIXWriter::default_batch_us) const
+		{ if (from) return from->FindAttr("write_batch_us", def); return def; }
+
+	/*! Extract the wait strategy for a thread role from a session entity. Uses "<role>_wait" if present,
+	  otherwise "wait_strategy"; the spin count and park timeout are taken from "wait_spins" and "wait_park_us".
+	  \param from xml entity to search
+	  \param role thread role: reader, writer, logger or persister
+	  \return the wait strategy, or blocking if not found */
+	WaitStrategy get_wait_strategy(const XmlElement *from, const std::string& role) const;
+
+	/*! Extract the thread policy for a thread role from a session entity. Each of "cpus" (e.g. "0-3,8"),
+	  "sched" (other, batch, idle, fifo or rr), "priority" and "numa_node" is taken from "<role>_<name>" if
+	  present, otherwise "<name>", otherwise from the default. Throws InvalidConfiguration.
+	  \param from xml entity to search
+	  \param role thread role: reader, callback, writer, timer, logger or persister; empty for none
+	  \param def policy to start from
+	  \return the thread policy */
+	ThreadPolicy get_thread_policy(const XmlElement *from, const std::string& role,
+		const ThreadPolicy& def=ThreadPolicy::global()) const;
+
+	/*! Extract the process wide thread policy from the fix8 entity attributes "cpus", "sched", "priority"
+	  and "numa_node".
+	  \return the thread policy */
+	ThreadPolicy get_default_thread_policy() const { return get_thread_policy(_root->find("fix8"), std::string(), ThreadPolicy()); }
+
 	/*! Extract the reset_sequence_number flag from a session entity.
 	  \param from xml entity to search
 	  \return true if reset_sequence_number flag was passed and was true */
 	bool get_reset_sequence_number_flag(const XmlElement *from)
 		{ return from && from->FindAttr("reset_sequence_numbers", false); }
 
+	/*! Extract the header_template flag from a session entity.
+	  \param from xml entity to search
+	  \return true if header_template flag was passed and was true */
+	bool get_header_template_flag(const XmlElement *from)
+		{ return from && from->FindAttr("header_template", false); }
+
 	/*! Extract default_appl_ver_id from a session entity.
 	  \param from xml entity to search
 	  \return target default_appl_ver_id */
@@ -40,6 +40,7 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 #include <Poco/Net/StreamSocket.h>
 #include <Poco/Timespan.h>
 #include <Poco/Net/NetException.h>
+#include <sys/uio.h>
 
 //----------------------------------------------------------------------------------------
 namespace FIX8 {
@@ -59,6 +60,7 @@ protected:
 	f8_concurrent_queue<T> _msg_queue;
 	Session& _session;
 	bool _pipelined;
+	WaitStrategy _wait;
 
 public:
 	/*! Ctor.
@@ -89,17 +91,27 @@ public:
 	    \return the socket */
 	Poco::Net::StreamSocket *socket() { return _sock; }
 
+	/*! Set what the processing thread does when its queue is empty.
+	    \param wait wait strategy */
+	void set_wait_strategy(const WaitStrategy& wait) { _wait = wait; }
+
+	/*! Set the placement and scheduling policy for the processing thread.
+	    \param policy thread policy */
+	void set_thread_policy(const ThreadPolicy& policy) { _thread.set_policy(policy); }
+
 	/*! Wait till processing thead has finished.
 	    \return 0 on success */
 	int join() { return _pipelined ? _thread.join() : -1; }
 };
 
 //----------------------------------------------------------------------------------------
-/// Fix message reader
-class FIXReader : public AsyncSocket<f8String>
+/// Fix message reader. Runs its own reader thread, or is serviced by a Reactor.
+class FIXReader : public AsyncSocket<f8String>, public ReactorHandler
 {
-	enum { _max_msg_len = MAX_MSG_LENGTH, _chksum_sz = 7 };
+	enum { _max_msg_len = MAX_MSG_LENGTH, _chksum_sz = 7, _rbuf_sz = 8 * MAX_MSG_LENGTH };
 	f8_atomic<bool> _socket_error;
+	Reactor *_reactor;
+	unsigned _processed, _dropped, _invalid;
 
 	dthread<FIXReader> _callback_thread;
 
@@ -109,37 +121,30 @@ class FIXReader : public AsyncSocket<f8String>
 
 	size_t _bg_sz; // 8=FIXx.x^A9=x
 
-	/*! Read a Fix message. Throws InvalidBodyLength, IllegalMessage.
-	    \param to string to place message in
-	    \return true on success */
-	bool read(f8String& to);
+	/// Receive buffer. Complete messages are split out from _rhead; a partial message carries over to the next fill.
+	char _rbuf[_rbuf_sz];
+	size_t _rhead, _rtail;
 
-	/*! Read bytes from the socket layer, throws PeerResetConnection.
-	    \param where buffer to place bytes in
-	    \param sz number of bytes to read
-	    \return number of bytes read */
-	int sockRead(char *where, size_t sz)
-	{
-		int rdSz(0);
-		unsigned remaining(sz), rddone(0);
+	/// Split every complete message from the receive buffer and queue or process it.
+	void dispatch();
 
-		while (remaining > 0)
-		{
-			if ((rdSz = _sock->receiveBytes(where + rddone, remaining)) <= 0)
-			{
-				if (errno == EAGAIN)
-					continue;
-				throw PeerResetConnection("connection gone");
-			}
+	/*! Log the message counts for this reader.
+	    \param retval reader exit value */
+	void report(const int retval);
 
-			rddone += rdSz;
-			remaining -= rdSz;
-		}
+protected:
+	/*! Read as many bytes as the socket layer has available into the receive buffer with a single call, blocking
+	    until at least one byte arrives. Throws PeerResetConnection if the peer has closed the connection or on a
+	    read error other than EINTR or EAGAIN. When driven by a reactor, EAGAIN returns 0 instead of retrying.
+	    \return number of bytes read */
+	size_t fill();
 
-		return rddone;
-	}
+	/*! Split the next complete Fix message from the receive buffer. Throws InvalidBodyLength, IllegalMessage,
+	    InvalidVersion; the receive buffer is discarded on error.
+	    \param to string to place message in
+	    \return true if a complete message was available */
+	bool frame(f8String& to);
 
-protected:
 	/*! Reader thread method. Reads messages and places them on the queue for processing.
 	    \return 0 on success */
 	int operator()();
@@ -150,13 +155,14 @@ public:
 	    \param session session
 	    \param pipelined true is pipelined */
 	FIXReader(Poco::Net::StreamSocket *sock, Session& session, const bool pipelined=true)
-		: AsyncSocket<f8String>(sock, session, pipelined), _callback_thread(ref(*this), &FIXReader::callback_processor), _bg_sz()
+		: AsyncSocket<f8String>(sock, session, pipelined), _reactor(), _processed(), _dropped(), _invalid(),
+		_callback_thread(ref(*this), &FIXReader::callback_processor), _bg_sz(), _rhead(), _rtail()
 	{
 		set_preamble_sz();
 	}
 
 	/// Dtor.
-	virtual ~FIXReader() {}
+	virtual ~FIXReader() { detach(); }
 
 	/// Start the processing threads.
 	virtual void start()
@@ -185,9 +191,29 @@ public:
 		{
 			const f8String from;
 			_msg_queue.try_push(from);
+			_wait.notify();
 		}
 	}
 
+	/*! Set the placement and scheduling policy for the callback thread.
+	    \param policy thread policy */
+	void set_callback_thread_policy(const ThreadPolicy& policy) { _callback_thread.set_policy(policy); }
+
+	/*! Start reading using a reactor instead of the reader thread. The callback thread is still started if pipelined.
+	    \param reactor reactor to register with
+	    \return true on success */
+	bool attach(Reactor *reactor);
+
+	/// Deregister from the reactor, if attached. Waits for any dispatch in progress on another thread.
+	void detach();
+
+	/*! Reactor callback. Reads what is available and processes each complete message.
+	    \return false if the socket has failed or the session is shutting down */
+	bool on_readable();
+
+	/// Reactor callback. Services the session timer.
+	void on_tick();
+
 	/// Calculate the length of the Fix message preamble, e.g. "8=FIX.4.4^A9=".
 	void set_preamble_sz();
 
@@ -197,10 +223,43 @@ public:
 };
 
 //----------------------------------------------------------------------------------------
-/// Fix message writer
+/// Fix message writer. When pipelined, messages queued together are encoded into consecutive frames
+/// and sent with a single gather write.
 class FIXWriter : public AsyncSocket<Message *>
 {
 protected:
+	enum { _max_batch = 64, _wbuf_sz = 8 * MAX_MSG_LENGTH };
+
+private:
+	/// Batch buffer. Encoded frames are copied in back to back, one iovec each, until flushed.
+	char _wbuf[_wbuf_sz];
+	iovec _iov[_max_batch];
+	size_t _wtail;
+	unsigned _batched, _batch_frames, _batch_us;
+	bool _batching;
+	Tickval _batch_start;
+	unsigned _writes, _frames_written, _max_frames_written;
+
+	/*! Check if the batch should be flushed before taking more from the queue.
+	    \return true if the frame or latency cap has been reached */
+	bool batch_full() const
+	{
+		return _batched >= _batch_frames
+			|| (_batch_us && _batched && (Tickval(true) - _batch_start).get_ticks() >= _batch_us * Tickval::thousand);
+	}
+
+protected:
+	/*! Append an encoded frame to the batch, flushing first if a cap would be exceeded.
+	    \param from buffer to send
+	    \param sz number of bytes to send
+	    \return number of bytes accepted */
+	int batch(const char *from, const size_t sz);
+
+	/*! Send all batched frames with a single gather write (repeated only for partial writes).
+	    Throws PeerResetConnection.
+	    \return number of bytes sent */
+	size_t flush();
+
 	/*! Writer thread method. Reads messages from the queue and sends them over the socket.
 	    \return 0 on success */
 	int operator()();
@@ -211,7 +270,10 @@ public:
 	    \param session session
 	    \param pipelined true is pipelined */
 	FIXWriter(Poco::Net::StreamSocket *sock, Session& session, const bool pipelined=true)
-		: AsyncSocket<Message *>(sock, session, pipelined) {}
+		: AsyncSocket<Message *>(sock, session, pipelined), _wtail(), _batched(), _batch_frames(default_batch_frames),
+		_batch_us(default_batch_us), _batching(), _writes(), _frames_written(), _max_frames_written() {}
+
+	enum { default_batch_frames = 32, default_batch_us = 1000 };
 
 	/// Dtor.
 	virtual ~FIXWriter() {}
@@ -222,7 +284,12 @@ public:
 	bool write(Message *from)
 	{
 		if (_pipelined)
-			return _msg_queue.try_push(from);
+		{
+			if (!_msg_queue.try_push(from))
+				return false;
+			_wait.notify();
+			return true;
+		}
 #if defined MSGRECYCLING
 		const bool result(_session.send_process(from));
 		from->set_in_use(false);
@@ -252,14 +319,23 @@ public:
 	/*! Send message over socket.
 	    \param msg message string to send
 	    \return number of bytes sent */
-	int send(const f8String& msg)
+	int send(const f8String& msg) { return send(msg.data(), msg.size()); }
+
+	/*! Send encoded message buffer over socket.
+	    \param from buffer to send
+	    \param sz number of bytes to send
+	    \return number of bytes sent */
+	int send(const char *from, const size_t sz)
 	{
+		if (_batching)
+			return batch(from, sz);
+
 		int wrtSz(0);
-		unsigned remaining(msg.size()), wrdone(0);
+		unsigned remaining(sz), wrdone(0);
 
 		while (remaining > 0)
 		{
-			if ((wrtSz = _sock->sendBytes(msg.data() + wrdone, remaining)) < 0)
+			if ((wrtSz = _sock->sendBytes(from + wrdone, remaining)) < 0)
 			{
 				if (errno == EAGAIN)
 					continue;
@@ -280,8 +356,29 @@ public:
 			AsyncSocket<Message *>::start();
 	}
 
+	/*! Set the batching caps. Only applies when pipelined.
+	    \param frames maximum frames per write; 1 disables batching
+	    \param us maximum age in us of the oldest batched frame before a flush is forced; 0 for no limit */
+	void set_batch(const unsigned frames, const unsigned us)
+	{
+		_batch_frames = frames == 0 ? 1 : frames > _max_batch ? static_cast<unsigned>(_max_batch) : frames;
+		_batch_us = us;
+	}
+
+	/*! Get the number of socket writes made by the writer thread.
+	    \return number of writes */
+	unsigned get_writes() const { return _writes; }
+
+	/*! Get the number of frames sent by the writer thread.
+	    \return number of frames */
+	unsigned get_frames_written() const { return _frames_written; }
+
+	/*! Get the largest number of frames sent with a single write.
+	    \return maximum frames per write */
+	unsigned get_max_frames_written() const { return _max_frames_written; }
+
 	/// Send a message to the processing method instructing it to quit.
-	virtual void stop() { _msg_queue.try_push(0); }
+	virtual void stop() { _msg_queue.try_push(0); _wait.notify(); }
 };
 
 //----------------------------------------------------------------------------------------
@@ -298,6 +395,7 @@ protected:
 	Session& _session;
 	Role _role;
 	unsigned _hb_interval, _hb_interval20pc;
+	Reactor *_reactor;
 
 	FIXReader _reader;
 	FIXWriter _writer;
@@ -309,7 +407,7 @@ public:
 	    \param pipelined if true, reader/writer are in separate pipelined threads */
 	Connection(Poco::Net::StreamSocket *sock, Session &session, const bool pipelined)	// client
 		: _sock(sock), _connected(), _session(session), _role(cn_initiator),
-		_hb_interval(10), _reader(sock, session, pipelined), _writer(sock, session, pipelined) {}
+		_hb_interval(10), _reactor(), _reader(sock, session, pipelined), _writer(sock, session, pipelined) {}
 
 	/*! Ctor. Acceptor.
 	    \param sock connected socket
@@ -318,7 +416,7 @@ public:
 	    \param pipelined if true, reader/writer are in separate pipelined threads */
 	Connection(Poco::Net::StreamSocket *sock, Session &session, const unsigned hb_interval, const bool pipelined) // server
 		: _sock(sock), _connected(true), _session(session), _role(cn_acceptor), _hb_interval(hb_interval),
-		_hb_interval20pc(hb_interval + hb_interval / 5),
+		_hb_interval20pc(hb_interval + hb_interval / 5), _reactor(),
 		  _reader(sock, session, pipelined), _writer(sock, session, pipelined) {}
 
 	/// Dtor.
@@ -328,7 +426,15 @@ public:
 	    \return the role */
 	Role get_role() const { return _role; }
 
-	/// Start the reader and writer threads.
+	/*! Have this connection's reader and session timer serviced by a reactor. Must be set before start.
+	    \param reactor reactor to use, or 0 to use a reader thread */
+	void set_reactor(Reactor *reactor) { _reactor = reactor; }
+
+	/*! Check if this connection is serviced by a reactor.
+	    \return true if serviced by a reactor */
+	bool is_reactive() const { return _reactor != 0; }
+
+	/// Start the reader and writer threads, or register the reader with the reactor.
 	void start();
 
 	/// Stop the reader and writer threads.
@@ -348,6 +454,34 @@ public:
 	    \return number of bytes written */
 	int send(const f8String& from) { return _writer.send(from); }
 
+	/*! Write an encoded message buffer to the underlying socket.
+	    \param from buffer to write
+	    \param sz number of bytes to write
+	    \return number of bytes written */
+	int send(const char *from, const size_t sz) { return _writer.send(from, sz); }
+
+	/*! Set the outbound batching caps.
+	    \param frames maximum frames per write; 1 disables batching
+	    \param us maximum age in us of the oldest batched frame before a flush is forced; 0 for no limit */
+	void set_write_batch(const unsigned frames, const unsigned us) { _writer.set_batch(frames, us); }
+
+	/*! Set what the reader callback and writer threads do when their queues are empty.
+	    \param reader reader wait strategy
+	    \param writer writer wait strategy */
+	void set_wait_strategies(const WaitStrategy& reader, const WaitStrategy& writer)
+		{ _reader.set_wait_strategy(reader); _writer.set_wait_strategy(writer); }
+
+	/*! Set the placement and scheduling policies for the reader, reader callback and writer threads.
+	    \param reader reader thread policy
+	    \param callback reader callback thread policy
+	    \param writer writer thread policy */
+	void set_thread_policies(const ThreadPolicy& reader, const ThreadPolicy& callback, const ThreadPolicy& writer)
+	{
+		_reader.set_thread_policy(reader);
+		_reader.set_callback_thread_policy(callback);
+		_writer.set_thread_policy(writer);
+	}
+
 	/*! Set the heartbeat interval for this connection.
 	    \param hb_interval heartbeat interval */
 	void set_hb_interval(const unsigned hb_interval)
@@ -361,9 +495,10 @@ public:
 	    \return the heartbeat interval + %20 */
 	unsigned get_hb_interval20pc() const { return _hb_interval20pc; }
 
-	/*! Wait till reader thead has finished.
+	/*! Wait till reader thead has finished. When serviced by a reactor, waits till the session
+	    is shutdown or the socket fails; if called from a reactor thread, returns -1 immediately.
 	    \return 0 on success */
-	int join() { return _reader.join(); }
+	int join();
 
 	/*! Check to see if the socket is in error
 	    \return true if there was a socket error */
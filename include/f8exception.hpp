@@ -254,6 +254,20 @@ struct InvalidConfiguration : f8Exception
 	InvalidConfiguration(const std::string& str) { format("Invalid configuration setting in", str); }
 };
 
+//-------------------------------------------------------------------------------------------------
+/// A fixed point Decimal value does not fit in its 64 bit mantissa.
+struct DecimalOverflow : f8Exception
+{
+	DecimalOverflow(const std::string& str) { format("Decimal value out of range", str); }
+};
+
+//-------------------------------------------------------------------------------------------------
+/// A fixed point Decimal value is not a valid FIX float.
+struct BadDecimal : f8Exception
+{
+	BadDecimal(const std::string& str) { format("Malformed Decimal value", str); }
+};
+
 //-------------------------------------------------------------------------------------------------
 
 } // FIX8
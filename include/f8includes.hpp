@@ -54,12 +54,16 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 #include <f8utils.hpp>
 #include <xml.hpp>
 #include <thread.hpp>
+#include <waitstrategy.hpp>
 #include <gzstream.hpp>
 #include <tickval.hpp>
+#include <frame.hpp>
 #include <logger.hpp>
 #include <traits.hpp>
 #include <timer.hpp>
+#include <reactor.hpp>
 #include <field.hpp>
+#include <tokenizer.hpp>
 #include <message.hpp>
 #include <session.hpp>
 #include <connection.hpp>
@@ -483,6 +483,23 @@ T fast_atoi(const char *str, const char term='\0')
 	return retval;
 }
 
+/*! Decode a bounded (non terminated) string into an int or unsigned.
+  \tparam typename
+  \param str source string
+  \param eptr pointer to last + 1 byte of source string
+  \return the converted value */
+template<typename T>
+T fast_atoi(const char *str, const char *eptr)
+{
+	const bool neg(str < eptr && *str == '-');
+	if (neg)
+		++str;
+	T retval(0);
+	for (; str < eptr; ++str)
+		retval = (retval << 3) + (retval << 1) + *str - '0';
+	return neg ? -retval : retval;
+}
+
 //----------------------------------------------------------------------------------------
 /**
  * C++ version 0.4 char* style "itoa":
@@ -616,6 +633,41 @@ inline double fast_atof (const char *p)
 	return sign * (frac ? (value / scale) : (value * scale));
 }
 
+/*! Bounded version of fast_atof; will not read beyond eptr. No exponent support.
+	\param p source string
+	\param eptr pointer to last + 1 byte of source string
+	\return double converted value */
+inline double fast_atof (const char *p, const char *eptr)
+{
+	double sign(1.), value(0.);
+
+	if (p < eptr)
+	{
+		if (*p == '-')
+		{
+			sign = -1.;
+			++p;
+		}
+		else if (*p == '+')
+			++p;
+	}
+
+	for (; p < eptr && isdigit(*p); ++p)
+		value = value * 10. + (*p - '0');
+
+	if (p < eptr && *p == '.')
+	{
+		double pow10(10.);
+		for (++p; p < eptr && isdigit(*p); ++p)
+		{
+			value += (*p - '0') / pow10;
+			pow10 *= 10.;
+		}
+	}
+
+	return sign * value;
+}
+
 //----------------------------------------------------------------------------------------
 /// Bitset for enums.
 /*! \tparam T the enum type
@@ -163,7 +163,7 @@ public:
 	}
 
 	ff_atomic<T*>& operator=(const ff_atomic<T*>& rhs)
-		{ atomic_long_set(&_rep, atomic_long_read(rhs._rep)); return *this; }
+		{ atomic_long_set(&_rep, atomic_long_read(&rhs._rep)); return *this; }
 
 	T* operator->() const { return reinterpret_cast<T*>(atomic_long_read(&_rep)); }
 	T operator*() { return *reinterpret_cast<T*>(atomic_long_read(&_rep)); }
@@ -39,8 +39,6 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include <Poco/Timestamp.h>
 #include <Poco/DateTime.h>
-#include <Poco/DateTimeParser.h>
-#include <Poco/DateTimeFormatter.h>
 
 //-------------------------------------------------------------------------------------------------
 namespace FIX8 {
@@ -103,6 +101,109 @@ struct RealmBase
 	}
 };
 
+//-------------------------------------------------------------------------------------------------
+#if defined FIELDPOOLING
+/// Per thread size class slab allocator for BaseField objects.
+/*! Each thread allocates from its own pool without locking. Slabs are aligned to their size so the owning
+    pool of any object can be found from its address; objects released by another thread are returned to the
+    owning pool's remote list (under lock) and reclaimed by the owner when its local free list runs dry.
+    Pools are never destroyed; the pool of an exiting thread is adopted by the next new thread. Slabs are never
+    returned to the operating system, so the memory held is the high water mark of live fields and pooled string
+    overflow blocks. */
+class FieldPool
+{
+public:
+	enum
+	{
+		granularity = 16,								///< allocation alignment and size class step
+		size_classes = 32,							///< largest pooled object is granularity * size_classes bytes
+		slab_size = 64 * 1024,						///< slabs are slab_size aligned
+		slab_header = granularity					///< space at start of each slab holding the owning pool
+	};
+
+private:
+	struct Block { Block *_next; };
+
+	Block *_free[size_classes], *_remote[size_classes];
+	/// number of blocks on each remote list; lets the owner check for remote blocks without taking the lock
+	f8_atomic<unsigned> _remote_cnt[size_classes];
+	f8_mutex _remote_mutex;
+	char *_cur, *_end;
+
+	FieldPool() : _cur(), _end()
+	{
+		for (unsigned ii(0); ii < size_classes; ++ii)
+		{
+			_free[ii] = _remote[ii] = 0;
+			_remote_cnt[ii] = 0;
+		}
+	}
+
+	/*! Find the pool owning an object.
+	  \param what object to look up
+	  \return pointer to owning pool */
+	static FieldPool *owner(void *what)
+		{ return *reinterpret_cast<FieldPool **>(reinterpret_cast<size_t>(what) & ~static_cast<size_t>(slab_size - 1)); }
+
+	/*! Get the pool for the calling thread; create or adopt one if necessary.
+	  \return pointer to pool */
+	static FieldPool *instance();
+
+	/*! Allocate a block of a given size class, from the free list, the remote list or a new slab.
+	  \param sclass size class
+	  \return pointer to block */
+	void *allocate(const unsigned sclass);
+
+	/*! Return a block to this pool.
+	  \param what block to return
+	  \param sclass size class
+	  \param remote true if called from a thread not owning this pool */
+	void release(void *what, const unsigned sclass, bool remote);
+
+	/// Create the thread specific key used to detect thread exit.
+	static void make_key();
+
+	/*! Thread exit handler; makes the exiting thread's pool available for adoption.
+	  \param pool pool of exiting thread */
+	static void thread_exit(void *pool);
+
+public:
+	/*! Allocate memory for a field.
+	  \param sz size in bytes
+	  \return pointer to memory */
+	static void *alloc(const size_t sz)
+	{
+		const unsigned sclass((sz - 1) / granularity);
+		return sclass < size_classes ? instance()->allocate(sclass) : ::operator new(sz);
+	}
+
+	/*! Free memory previously allocated with alloc.
+	  \param what pointer to memory
+	  \param sz size in bytes as passed to alloc */
+	static void free(void *what, const size_t sz)
+	{
+		if (!what)
+			return;
+		const unsigned sclass((sz - 1) / granularity);
+		if (sclass < size_classes)
+		{
+			FieldPool *pool(owner(what));
+			pool->release(what, sclass, pool != instance());
+		}
+		else
+			::operator delete(what);
+	}
+};
+#endif
+
+//-------------------------------------------------------------------------------------------------
+/// Pre-rendered "NNN=" encode prefix for a field tag; f8c generates a table of these indexed by tag.
+struct TagPrefix
+{
+	unsigned char _len;
+	char _str[7];
+};
+
 //-------------------------------------------------------------------------------------------------
 /// The base field class (ABC) for all fields
 class BaseField
@@ -121,6 +222,18 @@ public:
 	/// Dtor.
 	virtual ~BaseField() {}
 
+#if defined FIELDPOOLING
+	/*! Allocate a field from the calling thread's field pool.
+	  \param sz size of field
+	  \return pointer to memory */
+	static void *operator new(size_t sz) { return FieldPool::alloc(sz); }
+
+	/*! Return a field to its field pool.
+	  \param what pointer to field
+	  \param sz size of field */
+	static void operator delete(void *what, size_t sz) { FieldPool::free(what, sz); }
+#endif
+
 	/*! Get the fix tag id of this field.
 	  \return fix tag id (field num) */
 	unsigned short get_tag() const { return _fnum; }
@@ -162,12 +275,21 @@ public:
 	/*! Encode this field to the supplied stream.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream
+	  \param pfx pre-rendered tag prefix for this field; if 0 or empty the tag is converted
 	  \return the number of bytes encoded */
-	size_t encode(char *to, size_t& sz) const
+	size_t encode(char *to, size_t& sz, const TagPrefix *pfx=0) const
 	{
 		const size_t cur_sz(sz);
-		sz += itoa(_fnum, to + sz);
-		*(to + sz++) = '=';
+		if (pfx && pfx->_len)
+		{
+			::memcpy(to + sz, pfx->_str, pfx->_len);
+			sz += pfx->_len;
+		}
+		else
+		{
+			sz += itoa(_fnum, to + sz);
+			*(to + sz++) = '=';
+		}
 		print(to + sz, sz);
 		*(to + sz++) = default_field_separator;
 		return sz - cur_sz;
@@ -224,6 +346,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(fast_atoi<int>(from.c_str())) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(fast_atoi<int>(from, from + len)) {}
+
 	/// Assignment operator.
 	/*! \param that field to assign from
 	    \return field */
@@ -279,29 +407,132 @@ public:
 };
 
 //-------------------------------------------------------------------------------------------------
-/// Partial specialisation for f8String field type.
+/// Process wide intern table for low cardinality string field values.
+/*! The table is shared by every session in the process and lives until exit; values are never evicted, so the
+    returned pointer is stable and two interned values are equal if and only if their pointers are equal.
+    Lookups are served from a small per thread cache; misses take a single process wide lock. The table is bounded:
+    values longer than max_length are not interned, and once it holds max_entries values lookups for new values
+    return 0. In either case the caller must store the value itself, so a peer sending many distinct values only
+    loses the pointer comparison, never correctness. At most max_entries * max_length bytes of values are held. */
+class StringIntern
+{
+public:
+	enum { cache_size = 64, max_entries = 4096, max_length = 64 };
+
+	/*! Find or add a value in the intern table.
+	  \param from buffer holding value
+	  \param len length of value in buffer
+	  \return pointer to the interned string, or 0 if the value is too long or the table is full */
+	static const f8String *intern(const char *from, const size_t len);
+
+	/*! Find or add a value in the intern table.
+	  \param from value
+	  \return pointer to the interned string, or 0 if the value is too long or the table is full */
+	static const f8String *intern(const f8String& from) { return intern(from.data(), from.size()); }
+};
+
+/// Selects which string fields have their values interned. f8c generates a specialisation in the types header
+/// for each field named with -I (or marked intern="Y" in the schema), guarded by FIX8_INTERN_<tag>. The fields
+/// the runtime itself instantiates are selected here so every translation unit agrees on them.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
+struct InternField { enum { value = false }; };
+
+#define FIX8_INTERN_8
+template<> struct InternField<8> { enum { value = true }; };		// BeginString
+#define FIX8_INTERN_35
+template<> struct InternField<35> { enum { value = true }; };		// MsgType
+#define FIX8_INTERN_49
+template<> struct InternField<49> { enum { value = true }; };		// SenderCompID
+#define FIX8_INTERN_56
+template<> struct InternField<56> { enum { value = true }; };		// TargetCompID
+
+//-------------------------------------------------------------------------------------------------
+/// Partial specialisation for f8String field type.
+/*! Values up to inline_capacity bytes are held in the field itself; longer values overflow to a separately
+    allocated block (from the field pool if enabled). Values of fields selected by InternField are held in the
+    StringIntern table. data() and size() are the primary accessors. An f8String copy of the value is only built
+    if get() is called on a non interned field; the copy is published with a compare and swap, so concurrent
+    readers are safe and all see the same copy.
+    \tparam field field number (fix tag) */
+template<const unsigned short field>
 class Field<f8String, field> : public BaseField
 {
+public:
+	enum { inline_capacity = 32 };
+
 protected:
-	f8String _value;
+	const f8String *_interned;
+	mutable f8String *volatile _str;
+	char *_ovf;
+	unsigned _len;
+	char _sbuf[inline_capacity];
+
+	/// Release any overflow block and forget any interned value.
+	void release()
+	{
+		if (_ovf)
+		{
+#if defined FIELDPOOLING
+			FieldPool::free(_ovf, _len);
+#else
+			delete[] _ovf;
+#endif
+			_ovf = 0;
+		}
+		_interned = 0;
+	}
+
+	/*! Store a value.
+	  \param from buffer holding value
+	  \param len length of value in buffer */
+	void assign(const char *from, const size_t len)
+	{
+		release();
+		if (!InternField<field>::value || !(_interned = StringIntern::intern(from, len)))
+		{
+			if (len > inline_capacity)
+			{
+#if defined FIELDPOOLING
+				_ovf = static_cast<char *>(FieldPool::alloc(len));
+#else
+				_ovf = new char[len];
+#endif
+			}
+			::memcpy(_ovf ? _ovf : _sbuf, from, len);
+		}
+		_len = len;
+		if (_str)
+			_str->assign(from, len);
+	}
 
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
 	/// Ctor.
-	Field () : BaseField(field) {}
+	Field () : BaseField(field), _interned(), _str(), _ovf(), _len() {}
 
 	/// Copy Ctor.
 	/* \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value) {}
+	Field (const Field& from) : BaseField(field), _interned(from._interned), _str(), _ovf(), _len(from._len)
+	{
+		if (!_interned)
+			assign(from.data(), from._len);
+	}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(from) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _interned(), _str(), _ovf(), _len()
+		{ assign(from.data(), from.size()); }
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _interned(), _str(), _ovf(), _len()
+		{ assign(from, len); }
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -309,38 +540,88 @@ public:
 	Field& operator=(const Field& that)
 	{
 		if (this != &that)
-			_value = that._value;
+		{
+			if (that._interned)
+			{
+				release();
+				_interned = that._interned;
+				_len = that._len;
+			}
+			else
+				assign(that.data(), that._len);
+		}
 		return *this;
 	}
 
 	/// Dtor.
-	virtual ~Field() {}
+	virtual ~Field()
+	{
+		release();
+		delete _str;
+	}
 
 	/*! Check if this value is a member/in range of the domain set.
 	  \return true if in the set or no domain available */
-	virtual bool is_valid() const { return _rlm ? _rlm->is_valid(_value) : true; }
+	virtual bool is_valid() const { return _rlm ? _rlm->is_valid(get()) : true; }
 
 	/*! Get the realm index of this value in the domain set.
 	  \return the index in the domain set of this value */
-	virtual int get_rlm_idx() const { return _rlm ? _rlm->get_rlm_idx(_value) : -1; }
+	virtual int get_rlm_idx() const { return _rlm ? _rlm->get_rlm_idx(get()) : -1; }
 
-	/*! Get field value.
+	/*! Get field value. Builds an f8String copy on first call for a non interned field; use data() and size()
+	    to read the value in place.
 	  \return value (f8String) */
-	const f8String& get() const { return _value; }
+	const f8String& get() const
+	{
+		if (_interned)
+			return *_interned;
+		if (!_str)
+		{
+			f8String *str(new f8String(data(), _len));
+			if (!__sync_bool_compare_and_swap(&_str, static_cast<f8String *>(0), str))
+				delete str;	// another reader published first
+		}
+		return *_str;
+	}
 
 	/*! Get field value.
 	  \return value (f8String) */
-	const f8String& operator()() const { return _value; }
+	const f8String& operator()() const { return get(); }
+
+	/*! Get a pointer to the stored value; not null terminated.
+	  \return pointer to value */
+	const char *data() const { return _interned ? _interned->data() : _ovf ? _ovf : _sbuf; }
+
+	/*! Get the length of the stored value.
+	  \return length of value */
+	size_t size() const { return _len; }
+
+	/*! Get the interned value.
+	  \return pointer to interned value or 0 if not interned */
+	const f8String *interned() const { return _interned; }
+
+	/*! Compare this value with the value of another string field. If both values are interned this is a
+	    pointer comparison.
+	  \tparam tfield field number (fix tag) of other field
+	  \param that field to compare with
+	  \return true if the values are the same */
+	template<const unsigned short tfield>
+	bool same(const Field<f8String, tfield>& that) const
+	{
+		if (_interned && that.interned())
+			return _interned == that.interned();
+		return _len == that.size() && ::memcmp(data(), that.data(), _len) == 0;
+	}
 
 	/*! Get field value.
 	  \param from value to set
 	  \return original value (f8String) */
-	const f8String& set(const f8String& from) { return _value = from; }
+	const f8String& set(const f8String& from) { assign(from.data(), from.size()); return from; }
 
 	/*! Set the value from a string.
 	  \param from value to set
 	  \return original value (f8String) */
-	const f8String& set_from_raw(const f8String& from) { return _value = from; }
+	const f8String& set_from_raw(const f8String& from) { return set(from); }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -349,12 +630,12 @@ public:
 	/*! Print this field to the supplied stream. Used to format for FIX output.
 	  \param os stream to insert to
 	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os << _value; }
+	std::ostream& print(std::ostream& os) const { return os.write(data(), _len); }
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const { sz += _value.copy(to, _value.size()); }
+	void print(char *to, size_t& sz) const { ::memcpy(to, data(), _len); sz += _len; }
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -394,6 +675,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(fast_atof(from.c_str())), _precision(2) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(fast_atof(from, from + len)), _precision(2) {}
+
 	/// Assignment operator.
 	/*! \param that field to assign from
 	    \return field */
@@ -461,6 +748,320 @@ public:
 #endif
 };
 
+//-------------------------------------------------------------------------------------------------
+/// Scaled integer decimal (mantissa * 10^-exponent). Parsed and formatted exactly, without printf or floating point.
+class Decimal
+{
+	long long _mantissa;
+	int _exp;
+
+public:
+	enum { max_exp = 18 };
+	static const long long max_mantissa = 0x7fffffffffffffffLL;
+
+	/*! Get a power of ten.
+	  \param exp exponent, 0 to max_exp
+	  \return 10^exp */
+	static long long pow10(const int exp)
+	{
+		static const long long tens[max_exp + 1] =
+		{
+			1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+			10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+			1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+		};
+		return tens[exp];
+	}
+
+	/// Ctor.
+	Decimal() : _mantissa(), _exp() {}
+
+	/*! Value ctor.
+	  \param mantissa scaled integer value
+	  \param exp number of digits after the decimal point, 0 to max_exp */
+	Decimal(const long long mantissa, const int exp) : _mantissa(mantissa), _exp(exp) {}
+
+	/*! Convert from a double, rounded to the given number of decimal places. Throws DecimalOverflow if the
+	    scaled value does not fit in the mantissa.
+	  \param val value to convert
+	  \param prec number of digits after the decimal point; limited to 0 to max_exp
+	  \return Decimal */
+	static Decimal from_double(const double val, int prec)
+	{
+		prec = prec < 0 ? 0 : prec > max_exp ? static_cast<int>(max_exp) : prec;
+		const double scaled(val * pow10(prec) + (val < 0. ? -.5 : .5));
+		if (!(scaled > -9.2e18 && scaled < 9.2e18))	// also rejects NaN
+		{
+			std::ostringstream ostr;
+			ostr << val;
+			throw DecimalOverflow(ostr.str());
+		}
+		return Decimal(static_cast<long long>(scaled), prec);
+	}
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to parse
+	  \param len length of value in buffer */
+	Decimal(const char *from, const size_t len) : _mantissa(), _exp() { parse(from, len); }
+
+	/*! Parse a FIX float value. Fractional digits beyond max_exp, or beyond the precision of the mantissa
+	    (about 18 significant digits), are rounded half away from zero, as rescale() does. Throws BadDecimal if
+	    the value is not an optionally signed run of digits with at most one decimal point, and DecimalOverflow
+	    if the integer part does not fit.
+	  \param from buffer to parse
+	  \param len length of value in buffer
+	  \return *this */
+	Decimal& parse(const char *from, const size_t len)
+	{
+		const char *const start(from), *eptr(from + len);
+		bool neg(false), frac(false), digits(false), round(false), surplus(false);
+		_mantissa = 0;
+		_exp = 0;
+		if (from < eptr && (*from == '-' || *from == '+'))
+			neg = *from++ == '-';
+		for (; from < eptr; ++from)
+		{
+			if (*from == '.' && !frac)
+			{
+				frac = true;
+				continue;
+			}
+			if (*from < '0' || *from > '9')
+				throw BadDecimal(f8String(start, len));
+			digits = true;
+			if (surplus)
+				continue;
+			if ((frac && _exp == max_exp) || _mantissa > (max_mantissa - (*from - '0')) / 10)	// no room for another digit
+			{
+				if (!frac)
+					throw DecimalOverflow(f8String(start, len));
+				round = *from >= '5';	// the first dropped digit decides
+				surplus = true;
+				continue;
+			}
+			if (frac)
+				++_exp;
+			_mantissa = (_mantissa << 3) + (_mantissa << 1) + (*from - '0');
+		}
+		if (!digits)
+			throw BadDecimal(f8String(start, len));
+		if (round)
+		{
+			if (_mantissa == max_mantissa)
+				throw DecimalOverflow(f8String(start, len));
+			++_mantissa;
+		}
+		if (neg)
+			_mantissa = -_mantissa;
+		return *this;
+	}
+
+	/*! Format this value into the supplied buffer; no terminator is written.
+	  \param to buffer to format into (at least 21 bytes)
+	  \return number of bytes written */
+	size_t format(char *to) const
+	{
+		char buf[24], *ptr(buf + sizeof(buf));
+		unsigned long long val(_mantissa < 0 ? -static_cast<unsigned long long>(_mantissa) : _mantissa);
+		int digits(0);
+		do
+		{
+			*--ptr = val % 10 + '0';
+			val /= 10;
+			if (++digits == _exp)
+				*--ptr = '.';
+		}
+		while (val || digits <= _exp);
+		if (_mantissa < 0)
+			*--ptr = '-';
+		const size_t len(buf + sizeof(buf) - ptr);
+		::memcpy(to, ptr, len);
+		return len;
+	}
+
+	/*! Get the scaled integer value.
+	  \return mantissa */
+	long long mantissa() const { return _mantissa; }
+
+	/*! Get the number of digits after the decimal point.
+	  \return exponent */
+	int exponent() const { return _exp; }
+
+	/*! Get this value with a different number of decimal places, rounding half away from zero when reducing.
+	    Throws DecimalOverflow if the value does not fit at the new scale.
+	  \param exp required number of digits after the decimal point
+	  \return rescaled value */
+	Decimal rescale(const int exp) const
+	{
+		if (exp >= _exp)
+		{
+			if (!_mantissa)
+				return Decimal(0, exp);
+			const long long mul(exp - _exp <= max_exp ? pow10(exp - _exp) : 0);
+			if (!mul || (_mantissa < 0 ? -_mantissa : _mantissa) > max_mantissa / mul)
+			{
+				char buf[24];
+				throw DecimalOverflow(f8String(buf, format(buf)));
+			}
+			return Decimal(_mantissa * mul, exp);
+		}
+		if (_exp - exp > max_exp)	// rounds to zero
+			return Decimal(0, exp);
+		const long long div(pow10(_exp - exp)), half(_mantissa < 0 ? -div / 2 : div / 2);
+		return Decimal((_mantissa + half) / div, exp);
+	}
+
+	/*! Convert to a double.
+	  \return value as a double */
+	double todouble() const { return static_cast<double>(_mantissa) / pow10(_exp); }
+
+	/*! Compare two values exactly, without rescaling either mantissa in 64 bits (which could overflow).
+	  \param a lhs Decimal
+	  \param b rhs Decimal
+	  \return -1, 0 or 1 if a is less than, equal to or greater than b */
+	static int compare(const Decimal& a, const Decimal& b)
+	{
+		if (a._exp == b._exp)
+			return a._mantissa < b._mantissa ? -1 : a._mantissa > b._mantissa;
+		const bool swapped(a._exp > b._exp);
+		const Decimal& lo(swapped ? b : a), & hi(swapped ? a : b);	// lo has fewer decimal places
+		const long long mul(pow10(hi._exp - lo._exp));
+#if defined __SIZEOF_INT128__
+		const __int128 scaled(static_cast<__int128>(lo._mantissa) * mul);
+		const int result(scaled < hi._mantissa ? -1 : scaled > hi._mantissa);
+#else
+		// hi == quot * mul + rem, so lo * mul against hi is decided by lo against quot, then by the sign of rem
+		const long long quot(hi._mantissa / mul), rem(hi._mantissa % mul);
+		const int result(lo._mantissa < quot ? -1 : lo._mantissa > quot ? 1 : rem > 0 ? -1 : rem < 0);
+#endif
+		return swapped ? -result : result;
+	}
+
+	/*! Equivalence operator. Values are compared at a common scale, so 1.5 == 1.50.
+	  \param a lhs Decimal
+	  \param b rhs Decimal
+	  \return true if equal */
+	friend bool operator==(const Decimal& a, const Decimal& b) { return compare(a, b) == 0; }
+
+	/*! Inequivalence operator.
+	  \param a lhs Decimal
+	  \param b rhs Decimal
+	  \return true if not equal */
+	friend bool operator!=(const Decimal& a, const Decimal& b) { return !(a == b); }
+
+	/*! Less than operator.
+	  \param a lhs Decimal
+	  \param b rhs Decimal
+	  \return true if a is less than b */
+	friend bool operator<(const Decimal& a, const Decimal& b) { return compare(a, b) < 0; }
+
+	/*! Inserter friend.
+	    \param os stream to send to
+	    \param what Decimal to print
+	    \return stream */
+	friend std::ostream& operator<<(std::ostream& os, const Decimal& what)
+	{
+		char buf[24];
+		return os.write(buf, what.format(buf));
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+/// Partial specialisation for fixed point decimal field type. Selected by f8c for float types named with -F.
+/*! \tparam field field number (fix tag) */
+template<const unsigned short field>
+class Field<Decimal, field> : public BaseField
+{
+protected:
+	Decimal _value;
+
+public:
+	/// The FIX fieldID (tag number).
+	static unsigned short get_field_id() { return field; }
+
+	/// Ctor.
+	Field () : BaseField(field) {}
+
+	/// Copy Ctor.
+	/* \param from field to copy */
+	Field (const Field& from) : BaseField(field, from._rlm), _value(from._value) {}
+
+	/*! Value ctor.
+	  \param val value to set
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Decimal& val, const RealmBase *rlm=0) : BaseField(field, rlm), _value(val) {}
+
+	/*! Value ctor.
+	  \param val value to set
+	  \param prec precision digits
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const double& val, const int prec, const RealmBase *rlm=0) : BaseField(field, rlm), _value(Decimal::from_double(val, prec)) {}
+
+	/*! Construct from string ctor.
+	  \param from string to construct field from
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(from.data(), from.size()) {}
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(from, len) {}
+
+	/// Assignment operator.
+	/*! \param that field to assign from
+	    \return field */
+	Field& operator=(const Field& that)
+	{
+		if (this != &that)
+			_value = that._value;
+		return *this;
+	}
+
+	/// Dtor.
+	virtual ~Field() {}
+
+	/*! Check if this value is a member/in range of the domain set.
+	  \return true if in the set or no domain available */
+	virtual bool is_valid() const { return _rlm ? _rlm->is_valid(_value.todouble()) : true; }
+
+	/*! Get the realm index of this value in the domain set.
+	  \return the index in the domain set of this value */
+	virtual int get_rlm_idx() const { return _rlm ? _rlm->get_rlm_idx(_value.todouble()) : -1; }
+
+	/*! Get field value.
+	  \return value (Decimal) */
+	virtual const Decimal& get() const { return _value; }
+
+	/*! Get field value.
+	  \return value (Decimal) */
+	virtual const Decimal& operator()() const { return _value; }
+
+	/*! Set field value.
+	  \param from value to set
+	  \return original value (Decimal) */
+	virtual const Decimal& set(const Decimal& from) { return _value = from; }
+
+	/*! Set the value from a string.
+	  \param from value to set
+	  \return original value (Decimal) */
+	virtual const Decimal& set_from_raw(const f8String& from) { return _value.parse(from.data(), from.size()); }
+
+	/*! Copy (clone) this field.
+	  \return copy of field */
+	virtual Field *copy() { return new Field(*this); }
+
+	/*! Print this field to the supplied stream. Used to format for FIX output.
+	  \param os stream to insert to
+	  \return stream */
+	virtual std::ostream& print(std::ostream& os) const { return os << _value; }
+
+	/*! Print this field to the supplied buffer, update size written.
+	  \param to buffer to print to
+	  \param sz current size of buffer payload stream */
+	virtual void print(char *to, size_t& sz) const { sz += _value.format(to); }
+};
+
 //-------------------------------------------------------------------------------------------------
 /// Partial specialisation for unsigned short field type.
 /*! \tparam field field number (fix tag) */
@@ -490,6 +1091,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(from[0]) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(*from) {}
+
 	/// Assignment operator.
 	/*! \param that field to assign from
 	    \return field */
@@ -565,6 +1172,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<f8String, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<f8String, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -590,65 +1203,128 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<f8String, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<f8String, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
 
+//-------------------------------------------------------------------------------------------------
+/// Number of fractional second digits in a formatted time value.
+enum TimePrecision { tp_seconds = 0, tp_milliseconds = 3, tp_microseconds = 6, tp_nanoseconds = 9 };
+
+/*! Parse a FIX "YYYYMMDD-HH:MM:SS[.sss[sss[sss]]]" value by fixed position digit arithmetic.
+  \param from source buffer
+  \param len length of value in buffer
+  \param prec if not null, set to the precision found
+  \return nanoseconds since the epoch (UTC), or Tickval::noticks if the value is malformed, out of range or has
+    anything after it */
+Tickval::ticks date_time_parse(const char *from, const size_t len, TimePrecision *prec=0);
+
+/*! Format nanoseconds since the epoch as "YYYYMMDD-HH:MM:SS[.sss[sss[sss]]]". The "YYYYMMDD-" prefix is cached
+    per thread and only rebuilt when the day changes.
+  \param tv nanoseconds since the epoch (UTC)
+  \param to buffer to format into (at least 27 bytes); no terminator is written
+  \param prec number of fractional second digits to write
+  \return number of bytes written */
+size_t date_time_format(const Tickval::ticks tv, char *to, const TimePrecision prec);
+
+/*! Parse a FIX "HH:MM[:SS[.sss[sss[sss]]]]" value.
+  \param from source buffer
+  \param len length of value in buffer
+  \param prec if not null, set to the precision found
+  \param consumed if not null, set to the number of characters consumed (0 if malformed) and anything after the
+    time is left to the caller; if null, anything after the time makes the value malformed
+  \return nanoseconds since midnight, or Tickval::noticks if the value is malformed or out of range */
+Tickval::ticks time_parse(const char *from, const size_t len, TimePrecision *prec=0, size_t *consumed=0);
+
+/*! Format nanoseconds since midnight as "HH:MM:SS[.sss[sss[sss]]]".
+  \param tv nanoseconds since midnight (or since the epoch; the day is ignored)
+  \param to buffer to format into (at least 18 bytes); no terminator is written
+  \param prec number of fractional second digits to write
+  \return number of bytes written */
+size_t time_format(const Tickval::ticks tv, char *to, const TimePrecision prec);
+
+/*! Parse a FIX "YYYYMMDD" value.
+  \param from source buffer
+  \param len length of value in buffer
+  \return nanoseconds since the epoch of midnight (UTC) on that day, or Tickval::noticks if not a valid date */
+Tickval::ticks date_parse(const char *from, const size_t len);
+
+/*! Format the date part of nanoseconds since the epoch as "YYYYMMDD".
+  \param tv nanoseconds since the epoch (UTC)
+  \param to buffer to format into (at least 8 bytes); no terminator is written
+  \return number of bytes written */
+size_t date_format(const Tickval::ticks tv, char *to);
+
+/*! Parse a FIX timezone suffix "Z" or "+hh[:mm]"/"-hh[:mm]".
+  \param from source buffer
+  \param len length of suffix in buffer
+  \param valid if not null, set to false if the suffix is malformed or out of range
+  \return offset from UTC in minutes */
+int tz_parse(const char *from, const size_t len, bool *valid=0);
+
+/*! Format a timezone suffix, "Z" for UTC otherwise "+hh:mm"/"-hh:mm".
+  \param tzdiff offset from UTC in minutes
+  \param to buffer to format into (at least 6 bytes); no terminator is written
+  \return number of bytes written */
+size_t tz_format(const int tzdiff, char *to);
+
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_UTCTimestamp> UTCTimestamp;
 
-/// Partial specialisation for UTCTimestamp field type.
+/// Partial specialisation for UTCTimestamp field type. The value is held as nanoseconds since the epoch.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
 class Field<UTCTimestamp, field> : public BaseField
 {
-	static const std::string _fmt_sec, _fmt_ms;
-	enum MillisecondIndicator { _sec_only = 17, _with_ms = 21 };
-	Poco::DateTime _value;
-	int _tzdiff;
-
-protected:
-	void format0(short data, char *to, int width) const
-	{
-		while(width-- > 0)
-		{
-			to[width] = data % 10 + '0';
-			data /= 10;
-		}
-	}
-
-	void parseDate(std::string::const_iterator &begin, size_t len , short &to) const
-	{
-		while(len-- > 0)
-			to = (to << 3) + (to << 1) + (*begin++ - '0');
-	}
+	Tickval _value;
+	TimePrecision _prec;
 
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
-	/// Ctor.
-	Field () : BaseField(field), _tzdiff() {}
+	/// Ctor. Value is the current time.
+	Field () : BaseField(field), _value(true), _prec(tp_milliseconds) {}
 
 	/*! Copy Ctor.
 	  \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value), _tzdiff(from._tzdiff) {}
+	Field (const Field& from) : BaseField(field), _value(from._value), _prec(from._prec) {}
 
 	/*! Value ctor.
 	  \param val value to set
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const Poco::DateTime& val, const RealmBase *rlm=0) : BaseField(field, rlm), _value(val) {}
+	Field (const Tickval& val, const RealmBase *rlm=0) : BaseField(field, rlm), _value(val), _prec(tp_milliseconds) {}
+
+	/*! Value ctor.
+	  \param val value to set
+	  \param prec number of fractional second digits to encode
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Tickval& val, const TimePrecision prec, const RealmBase *rlm=0) : BaseField(field, rlm), _value(val), _prec(prec) {}
+
+	/*! Value ctor.
+	  \param val value to set
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Poco::DateTime& val, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(static_cast<Tickval::ticks>(val.timestamp().epochMicroseconds()) * Tickval::thousand), _prec(tp_milliseconds) {}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field)
-	{
-		if (from.size() == _sec_only) // 19981231-23:59:59
-			DateTimeParse(from, _value, _sec_only);
-		else if (from.size() == _with_ms) // 19981231-23:59:59.123
-			DateTimeParse(from, _value, _with_ms);
-	}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(date_time_parse(from.data(), from.size(), &_prec)) {}
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(date_time_parse(from, len, &_prec)) {}
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -658,7 +1334,7 @@ public:
 		if (this != &that)
 		{
 			_value = that._value;
-			_tzdiff = that._tzdiff;
+			_prec = that._prec;
 		}
 		return *this;
 	}
@@ -667,21 +1343,25 @@ public:
 	virtual ~Field() {}
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& get() const { return _value; }
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& operator()() const { return _value; }
 
 	/*! Set field to the supplied value.
 	  \param from value to set
-	  \return the new value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	  \return the new value (Tickval) */
+	const Tickval& set(const f8String& from) { return _value = Tickval(date_time_parse(from.data(), from.size(), &_prec)); }
 
 	/*! Set field to the supplied value.
 	  \param from value to set */
-	void set(const Poco::DateTime& from) { _value = from; }
+	void set(const Tickval& from) { _value = from; }
+
+	/*! Set the number of fractional second digits to encode.
+	  \param prec precision */
+	void set_precision(const TimePrecision prec) { _prec = prec; }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -691,103 +1371,57 @@ public:
 	  \param os stream to insert to
 	  \return stream */
 	std::ostream& print(std::ostream& os) const
-		{ return os << Poco::DateTimeFormatter::format(_value, _fmt_sec); }
-
-	/*! Format Poco::DateTime into a string.
-		 With millisecond, the format string will be "YYYYMMDD-HH:MM:SS.MMM"
-		 Without millisecond, the format string will be "YYYYMMDD-HH:MM:SS"
-	  \param dateTime input Poco::DateTime object
-	  \param to output buffer, should make sure there is enough space reserved
-	  \param ind indicating whether need millisecond or not
-	  \return length of formatted string */
-	size_t DateTimeFormat(const Poco::DateTime& dateTime, char *to, const MillisecondIndicator ind=_sec_only) const;
-
-	/*! Decode a DateTime string into a Poco::DateTime
-	  \param from input DateTime string
-	  \param dateTime output Poco::DateTime object
-	  \param ind indicating whether the string has millisecond or not */
-	void DateTimeParse(const std::string& from, Poco::DateTime& dateTime, const MillisecondIndicator ind=_sec_only) const;
+	{
+		char buf[32];
+		return os.write(buf, date_time_format(_value.get_ticks(), buf, _prec));
+	}
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const { sz += DateTimeFormat(_value, to, _with_ms); }
+	void print(char *to, size_t& sz) const { sz += date_time_format(_value.get_ticks(), to, _prec); }
 };
 
-template<const unsigned short field>
-inline size_t Field<UTCTimestamp, field>::DateTimeFormat(const Poco::DateTime& dateTime, char *to, const MillisecondIndicator ind) const
-{
-	format0(dateTime.year(), to, 4);
-	format0(dateTime.month(), to + 4, 2);
-	format0(dateTime.day(), to + 6, 2);
-	to[8] = '-';
-
-	format0(dateTime.hour(), to + 9, 2);
-	to[11] = ':';
-
-	format0(dateTime.minute(), to + 12, 2);
-	to[14] = ':';
-
-	format0(dateTime.second(), to + 15, 2);
-
-	if(ind != _with_ms)
-		return _sec_only; //length of "YYYYMMDD-HH:MM:SS"
-
-	to[17] = '.';
-	format0(dateTime.millisecond(), to + 18, 3);
-	return _with_ms; //length of "YYYYMMDD-HH:MM:SS.MMM"
-}
-
-template<const unsigned short field>
-inline void Field<UTCTimestamp, field>::DateTimeParse(const std::string& from, Poco::DateTime& dateTime, const MillisecondIndicator ind) const
-{
-	std::string::const_iterator it(from.begin());
-	short year(0), month(0), day(0), hour(0), minute(0), second(0), millisecond(0);
-
-	parseDate(it, 4, year);
-	parseDate(it, 2, month);
-	parseDate(it, 2, day);
-	parseDate(++it, 2, hour);
-	parseDate(++it, 2, minute);
-	parseDate(++it, 2, second);
-
-	if(ind == _with_ms)
-		parseDate(++it, 3, millisecond);
-
-	if (Poco::DateTime::isValid(year, month, day, hour, minute, second, millisecond))
-		dateTime.assign(year, month, day, hour, minute, second, millisecond);
-}
-
-template<const unsigned short field>
-const std::string Field<UTCTimestamp, field>::_fmt_sec("%Y%m%d-%H:%M:%S");
-template<const unsigned short field>
-const std::string Field<UTCTimestamp, field>::_fmt_ms("%Y%m%d-%H:%M:%S.%i");
-
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_UTCTimeOnly> UTCTimeOnly;
 
-/// Partial specialisation for UTCTimeOnly field type.
+/// Partial specialisation for UTCTimeOnly field type. The value is held as nanoseconds since midnight.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
 class Field<UTCTimeOnly, field> : public BaseField
 {
-	Poco::DateTime _value;
+	Tickval _value;
+	TimePrecision _prec;
 
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
 	/// Ctor.
-	Field () : BaseField(field) {}
+	Field () : BaseField(field), _prec(tp_milliseconds) {}
 
 	/// Copy Ctor.
 	/* \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value) {}
+	Field (const Field& from) : BaseField(field), _value(from._value), _prec(from._prec) {}
+
+	/*! Value ctor.
+	  \param val value to set
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Tickval& val, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(val.get_ticks() % (86400 * Tickval::billion)), _prec(tp_milliseconds) {}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(time_parse(from.data(), from.size(), &_prec)) {}
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(time_parse(from, len, &_prec)) {}
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -795,7 +1429,10 @@ public:
 	Field& operator=(const Field& that)
 	{
 		if (this != &that)
+		{
 			_value = that._value;
+			_prec = that._prec;
+		}
 		return *this;
 	}
 
@@ -803,17 +1440,21 @@ public:
 	virtual ~Field() {}
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& get() const { return _value; }
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& operator()() const { return _value; }
 
-	/*! Get field value.
+	/*! Set field to the supplied value.
 	  \param from value to set
-	  \return original value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	  \return the new value (Tickval) */
+	const Tickval& set(const f8String& from) { return _value = Tickval(time_parse(from.data(), from.size(), &_prec)); }
+
+	/*! Set the number of fractional second digits to encode.
+	  \param prec precision */
+	void set_precision(const TimePrecision prec) { _prec = prec; }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -822,23 +1463,28 @@ public:
 	/*! Print this field to the supplied stream. Used to format for FIX output.
 	  \param os stream to insert to
 	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os; }  	// TODO
+	std::ostream& print(std::ostream& os) const
+	{
+		char buf[32];
+		return os.write(buf, time_format(_value.get_ticks(), buf, _prec));
+	}
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const {}  	// TODO
+	void print(char *to, size_t& sz) const { sz += time_format(_value.get_ticks(), to, _prec); }
 };
 
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_UTCDateOnly> UTCDateOnly;
 
-/// Partial specialisation for UTCDateOnly field type.
+/// Partial specialisation for UTCDateOnly field type. The value is held as nanoseconds since the epoch of midnight.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
 class Field<UTCDateOnly, field> : public BaseField
 {
-	Poco::DateTime _value;
+protected:
+	Tickval _value;
 
 public:
 	/// The FIX fieldID (tag number).
@@ -851,10 +1497,22 @@ public:
 	/* \param from field to copy */
 	Field (const Field& from) : BaseField(field), _value(from._value) {}
 
+	/*! Value ctor.
+	  \param val value to set
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Tickval& val, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(val.get_ticks() - val.get_ticks() % (86400 * Tickval::billion)) {}
+
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(date_parse(from.data(), from.size())) {}
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(date_parse(from, len)) {}
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -870,17 +1528,17 @@ public:
 	virtual ~Field() {}
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& get() const { return _value; }
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& operator()() const { return _value; }
 
-	/*! Get field value.
+	/*! Set field to the supplied value.
 	  \param from value to set
-	  \return original value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	  \return the new value (Tickval) */
+	const Tickval& set(const f8String& from) { return _value = Tickval(date_parse(from.data(), from.size())); }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -889,106 +1547,100 @@ public:
 	/*! Print this field to the supplied stream. Used to format for FIX output.
 	  \param os stream to insert to
 	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os; }  	// TODO
+	std::ostream& print(std::ostream& os) const
+	{
+		char buf[16];
+		return os.write(buf, date_format(_value.get_ticks(), buf));
+	}
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const {}  	// TODO
+	void print(char *to, size_t& sz) const { sz += date_format(_value.get_ticks(), to); }
 };
 
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_LocalMktDate> LocalMktDate;
 
-/// Partial specialisation for LocalMktDate field type.
+/// Partial specialisation for LocalMktDate field type. Same encoding as UTCDateOnly.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
-class Field<LocalMktDate, field> : public BaseField
+class Field<LocalMktDate, field> : public Field<UTCDateOnly, field>
 {
-	Poco::DateTime _value;
-
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
 	/// Ctor.
-	Field () : BaseField(field) {}
+	Field () : Field<UTCDateOnly, field>() {}
 
-	/// Copy Ctor.
-	/* \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value) {}
+	/*! Value ctor.
+	  \param val value to set
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Tickval& val, const RealmBase *rlm=0) : Field<UTCDateOnly, field>(val, rlm) {}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : Field<UTCDateOnly, field>(from, rlm) {}
 
-	/// Assignment operator.
-	/*! \param that field to assign from
-	    \return field */
-	Field& operator=(const Field& that)
-	{
-		if (this != &that)
-			_value = that._value;
-		return *this;
-	}
-
-	/// Dtor.
-	virtual ~Field() {}
-
-	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
-
-	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
-
-	/*! Get field value.
-	  \param from value to set
-	  \return original value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<UTCDateOnly, field>(from, len, rlm) {}
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
 	virtual Field *copy() { return new Field(*this); }
 
-	/*! Print this field to the supplied stream. Used to format for FIX output.
-	  \param os stream to insert to
-	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os; }  	// TODO
-
-	/*! Print this field to the supplied buffer, update size written.
-	  \param to buffer to print to
-	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const {}  	// TODO
+	/// Dtor.
+	virtual ~Field() {}
 };
 
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_TZTimeOnly> TZTimeOnly;
 
-/// Partial specialisation for TZTimeOnly field type.
+/// Partial specialisation for TZTimeOnly field type. The value is held as local nanoseconds since midnight with an offset from UTC.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
 class Field<TZTimeOnly, field> : public BaseField
 {
-	Poco::DateTime _value;
+	Tickval _value;
+	TimePrecision _prec;
+	int _tzdiff;
+
+	void parse(const char *from, const size_t len)
+	{
+		size_t consumed(0);
+		bool valid(false);
+		_value = Tickval(time_parse(from, len, &_prec, &consumed));
+		_tzdiff = tz_parse(from + consumed, len - consumed, &valid);
+		if (!consumed || !valid)
+			_value = Tickval();
+	}
 
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
 	/// Ctor.
-	Field () : BaseField(field) {}
+	Field () : BaseField(field), _prec(tp_seconds), _tzdiff() {}
 
 	/// Copy Ctor.
 	/* \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value) {}
+	Field (const Field& from) : BaseField(field), _value(from._value), _prec(from._prec), _tzdiff(from._tzdiff) {}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) { parse(from.data(), from.size()); }
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm) { parse(from, len); }
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -996,7 +1648,11 @@ public:
 	Field& operator=(const Field& that)
 	{
 		if (this != &that)
+		{
 			_value = that._value;
+			_prec = that._prec;
+			_tzdiff = that._tzdiff;
+		}
 		return *this;
 	}
 
@@ -1004,16 +1660,21 @@ public:
 	virtual ~Field() {}
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
+	  \return value (Tickval) */
+	const Tickval& get() const { return _value; }
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
-	/*! Get field value.
+	  \return value (Tickval) */
+	const Tickval& operator()() const { return _value; }
+
+	/*! Get the offset from UTC.
+	  \return offset in minutes */
+	int get_tzdiff() const { return _tzdiff; }
+
+	/*! Set field to the supplied value.
 	  \param from value to set
-	  \return original value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	  \return the new value (Tickval) */
+	const Tickval& set(const f8String& from) { parse(from.data(), from.size()); return _value; }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -1022,39 +1683,76 @@ public:
 	/*! Print this field to the supplied stream. Used to format for FIX output.
 	  \param os stream to insert to
 	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os; }  	// TODO
+	std::ostream& print(std::ostream& os) const
+	{
+		char buf[32];
+		size_t sz(0);
+		print(buf, sz);
+		return os.write(buf, sz);
+	}
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const {}  	// TODO
+	void print(char *to, size_t& sz) const
+	{
+		const size_t len(time_format(_value.get_ticks(), to, _prec));
+		sz += len + tz_format(_tzdiff, to + len);
+	}
 };
 
 //-------------------------------------------------------------------------------------------------
 typedef EnumType<FieldTrait::ft_TZTimestamp> TZTimestamp;
 
-/// Partial specialisation for TZTimestamp field type.
+/// Partial specialisation for TZTimestamp field type. The value is held as UTC nanoseconds since the epoch with an offset from UTC.
 /*! \tparam field field number (fix tag) */
 template<const unsigned short field>
 class Field<TZTimestamp, field> : public BaseField
 {
-	Poco::DateTime _value;
+	Tickval _value;
+	TimePrecision _prec;
+	int _tzdiff;
+
+	void parse(const char *from, const size_t len)
+	{
+		size_t dtlen(std::min(len, static_cast<size_t>(17)));	// YYYYMMDD-HH:MM:SS then optional fraction
+		while (dtlen < len && (from[dtlen] == '.' || (from[dtlen] >= '0' && from[dtlen] <= '9')))
+			++dtlen;
+		bool valid(false);
+		_tzdiff = tz_parse(from + dtlen, len - dtlen, &valid);
+		const long long offset(static_cast<long long>(_tzdiff) * 60 * Tickval::billion);
+		const Tickval::ticks local(date_time_parse(from, dtlen, &_prec));
+		_value = Tickval(local == Tickval::noticks || !valid ? Tickval::noticks : static_cast<Tickval::ticks>(local - offset));
+	}
 
 public:
 	/// The FIX fieldID (tag number).
 	static unsigned short get_field_id() { return field; }
 
 	/// Ctor.
-	Field () : BaseField(field) {}
+	Field () : BaseField(field), _prec(tp_seconds), _tzdiff() {}
 
 	/// Copy Ctor.
 	/* \param from field to copy */
-	Field (const Field& from) : BaseField(field), _value(from._value) {}
+	Field (const Field& from) : BaseField(field), _value(from._value), _prec(from._prec), _tzdiff(from._tzdiff) {}
+
+	/*! Value ctor.
+	  \param val UTC value to set
+	  \param tzdiff offset from UTC in minutes used when encoding
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const Tickval& val, const int tzdiff=0, const RealmBase *rlm=0) : BaseField(field, rlm),
+		_value(val), _prec(tp_milliseconds), _tzdiff(tzdiff) {}
 
 	/*! Construct from string ctor.
 	  \param from string to construct field from
 	  \param rlm pointer to the realmbase for this field (if available) */
-	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) {}
+	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm) { parse(from.data(), from.size()); }
+
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm) { parse(from, len); }
 
 	/// Assignment operator.
 	/*! \param that field to assign from
@@ -1062,7 +1760,11 @@ public:
 	Field& operator=(const Field& that)
 	{
 		if (this != &that)
+		{
 			_value = that._value;
+			_prec = that._prec;
+			_tzdiff = that._tzdiff;
+		}
 		return *this;
 	}
 
@@ -1070,17 +1772,21 @@ public:
 	virtual ~Field() {}
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& get() const { return _value; }
+	  \return UTC value (Tickval) */
+	const Tickval& get() const { return _value; }
 
 	/*! Get field value.
-	  \return value (Poco::DateTime) */
-	const Poco::DateTime& operator()() const { return _value; }
+	  \return UTC value (Tickval) */
+	const Tickval& operator()() const { return _value; }
 
-	/*! Get field value.
+	/*! Get the offset from UTC.
+	  \return offset in minutes */
+	int get_tzdiff() const { return _tzdiff; }
+
+	/*! Set field to the supplied value.
 	  \param from value to set
-	  \return original value (Poco::DateTime) */
-	const Poco::DateTime& set(const f8String& from) { return _value = from; }
+	  \return the new value (Tickval) */
+	const Tickval& set(const f8String& from) { parse(from.data(), from.size()); return _value; }
 
 	/*! Copy (clone) this field.
 	  \return copy of field */
@@ -1089,12 +1795,23 @@ public:
 	/*! Print this field to the supplied stream. Used to format for FIX output.
 	  \param os stream to insert to
 	  \return stream */
-	std::ostream& print(std::ostream& os) const { return os; }  	// TODO
+	std::ostream& print(std::ostream& os) const
+	{
+		char buf[40];
+		size_t sz(0);
+		print(buf, sz);
+		return os.write(buf, sz);
+	}
 
 	/*! Print this field to the supplied buffer, update size written.
 	  \param to buffer to print to
 	  \param sz current size of buffer payload stream */
-	void print(char *to, size_t& sz) const {}  	// TODO
+	void print(char *to, size_t& sz) const
+	{
+		const long long offset(static_cast<long long>(_tzdiff) * 60 * Tickval::billion);
+		const size_t len(date_time_format(static_cast<Tickval::ticks>(_value.get_ticks() + offset), to, _prec));
+		sz += len + tz_format(_tzdiff, to + len);
+	}
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -1123,6 +1840,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<int, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<int, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1153,6 +1876,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<int, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<int, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1183,6 +1912,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<int, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<int, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1213,6 +1948,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<int, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<int, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1243,6 +1984,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<int, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<int, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1282,6 +2029,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : BaseField(field, rlm), _value(toupper(from[0]) == 'Y') {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : BaseField(field, rlm), _value(toupper(*from) == 'Y') {}
+
 	/// Assignment operator.
 	/*! \param that field to assign from
 	    \return field */
@@ -1361,6 +2114,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm=0) : Field<double, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<double, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1389,6 +2148,12 @@ public:
 	  \param rlm pointer to the realmbase for this field (if available) */
 	Field (const f8String& from, const RealmBase *rlm) : Field<f8String, field>(from, rlm) {}
 
+	/*! Construct from raw buffer ctor.
+	  \param from buffer to construct field from
+	  \param len length of value in buffer
+	  \param rlm pointer to the realmbase for this field (if available) */
+	Field (const char *from, const size_t len, const RealmBase *rlm=0) : Field<f8String, field>(from, len, rlm) {}
+
 	/// Dtor.
 	virtual ~Field() {}
 };
@@ -1397,7 +2162,7 @@ public:
 /// Field metadata structure
 struct BaseEntry
 {
-	BaseField *(*_create)(const f8String& str, const RealmBase* rlm, const int rv);
+	BaseField *(*_create)(const char *from, const size_t len, const RealmBase* rlm, const int rv);
 	const RealmBase *_rlm;
 	const char *_name, *_comment;
 };
@@ -1409,9 +2174,60 @@ struct BaseEntry
   \param name Field name
   \param comment Field comments
   \return BaseEntry object */
-BaseEntry *BaseEntry_ctor(BaseEntry *be, BaseField *(*create)(const f8String&, const RealmBase*, const int),
+BaseEntry *BaseEntry_ctor(BaseEntry *be, BaseField *(*create)(const char *, const size_t, const RealmBase*, const int),
 	const RealmBase *rlm, const char *name, const char *comment);
 
+//-------------------------------------------------------------------------------------------------
+/// A field value in place in a source buffer, with its schema type; presented to a MessageVisitor.
+/*! No field object is constructed. The typed accessors convert the value on each call. */
+class FieldValue
+{
+	const char *_data;
+	unsigned _len;
+	FieldTrait::FieldType _ftype;
+	const BaseEntry *_be;
+
+public:
+	/*! Ctor.
+	  \param data pointer to value in source buffer
+	  \param len length of value
+	  \param ftype schema type of field
+	  \param be field metadata */
+	FieldValue(const char *data, const unsigned len, const FieldTrait::FieldType ftype, const BaseEntry *be)
+		: _data(data), _len(len), _ftype(ftype), _be(be) {}
+
+	/*! Get a pointer to the value; not null terminated.
+	  \return pointer to value */
+	const char *data() const { return _data; }
+
+	/*! Get the length of the value.
+	  \return length */
+	unsigned size() const { return _len; }
+
+	/*! Get the schema type of the field.
+	  \return field type */
+	FieldTrait::FieldType type() const { return _ftype; }
+
+	/*! Get the field metadata (name, realm).
+	  \return pointer to metadata */
+	const BaseEntry *entry() const { return _be; }
+
+	/// Typed accessors.
+	f8String as_string() const { return f8String(_data, _len); }
+	int as_int() const { return fast_atoi<int>(_data, _data + _len); }
+	double as_double() const { return fast_atof(_data, _data + _len); }
+	Decimal as_decimal() const { return Decimal(_data, _len); }
+	char as_char() const { return _len ? *_data : 0; }
+	bool as_bool() const { return _len && toupper(*_data) == 'Y'; }
+	Tickval as_timestamp() const { return Tickval(date_time_parse(_data, _len)); }
+
+	/*! Inserter friend.
+	    \param os stream to send to
+	    \param what FieldValue
+	    \return stream */
+	friend std::ostream& operator<<(std::ostream& os, const FieldValue& what) { return os.write(what._data, what._len); }
+};
+
 //-------------------------------------------------------------------------------------------------
 // Common (administrative) msgtypes
 const f8String Common_MsgType_HEARTBEAT("0");
@@ -0,0 +1,133 @@
+//-------------------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+#ifndef _FIX8_FRAME_HPP_
+#define _FIX8_FRAME_HPP_
+
+//-------------------------------------------------------------------------------------------------
+namespace FIX8 {
+
+//-------------------------------------------------------------------------------------------------
+/*! Reference counted encoded outbound message. The encoder writes into the frame buffer once; copies
+    share the same buffer, so the socket writer, protocol logger and persister can all hold the
+    frame without copying it. Buffers are recycled through a small global pool, which is drained at exit. */
+class OutboundFrame
+{
+public:
+	/// Bytes reserved ahead of the body for the back-filled BeginString/BodyLength prefix
+	enum { prefix_reserve = 32, buffer_size = prefix_reserve + MAX_MSG_LENGTH, pool_max = 64 };
+
+private:
+	struct Rep
+	{
+		f8_atomic<int> _refs;
+		const char *_frame;
+		unsigned _len;
+		char _buffer[buffer_size];
+	};
+	Rep *_rep;
+
+	class Pool;
+	static Pool _pool;
+
+	/*! Take a buffer from the pool or allocate a new one.
+	    \return buffer with a reference count of 1 */
+	static Rep *acquire();
+
+	/*! Drop a reference to a buffer, returning it to the pool when it is no longer shared.
+	    \param rep buffer to release */
+	static void release(Rep *rep);
+
+public:
+	/// Ctor. Creates an empty frame.
+	OutboundFrame() : _rep() {}
+
+	/// Copy Ctor. Shares the buffer.
+	OutboundFrame(const OutboundFrame& from) : _rep(from._rep) { if (_rep) ++_rep->_refs; }
+
+	/// Assignment operator. Shares the buffer.
+	OutboundFrame& operator=(const OutboundFrame& that)
+	{
+		if (that._rep)
+			++that._rep->_refs;
+		reset();
+		_rep = that._rep;
+		return *this;
+	}
+
+	/// Dtor. Releases the buffer.
+	~OutboundFrame() { reset(); }
+
+	/// Release the buffer, leaving the frame empty.
+	void reset()
+	{
+		if (_rep)
+		{
+			release(_rep);
+			_rep = 0;
+		}
+	}
+
+	/*! Get an unshared buffer of buffer_size bytes to encode into. Any previous contents are released.
+	    \return pointer to start of buffer */
+	char *prepare()
+	{
+		reset();
+		_rep = acquire();
+		return _rep->_buffer;
+	}
+
+	/*! Mark the encoded frame within the buffer returned by prepare().
+	    \param frame pointer to first byte of frame
+	    \param len length of frame */
+	void set(const char *frame, const unsigned len) { _rep->_frame = frame; _rep->_len = len; }
+
+	/*! Get a pointer to the encoded frame.
+	    \return pointer to frame or 0 if empty */
+	const char *data() const { return _rep ? _rep->_frame : 0; }
+
+	/*! Get the length of the encoded frame.
+	    \return length of frame */
+	unsigned size() const { return _rep ? _rep->_len : 0; }
+
+	/*! Check if the frame holds an encoded message.
+	    \return true if empty */
+	bool empty() const { return !_rep || !_rep->_len; }
+};
+
+} // FIX8
+
+#endif // _FIX8_FRAME_HPP_
+
@@ -175,19 +175,24 @@ protected:
 	{
 		pthread_t _tid;
 		std::string _str;
+		OutboundFrame _frame;
 		unsigned _val;
 		Tickval _when;
 
 		LogElement(const pthread_t tid, const std::string& str, const unsigned val=0)
 			: _tid(tid), _str(str), _val(val), _when(true) {}
+		LogElement(const pthread_t tid, const OutboundFrame& frame, const unsigned val=0)
+			: _tid(tid), _frame(frame), _val(val), _when(true) {}
 		LogElement() : _tid(), _val(), _when(true) {}
-		LogElement(const LogElement& from) : _tid(from._tid), _str(from._str), _val(from._val), _when(from._when) {}
+		LogElement(const LogElement& from)
+			: _tid(from._tid), _str(from._str), _frame(from._frame), _val(from._val), _when(from._when) {}
 		LogElement& operator=(const LogElement& that)
 		{
 			if (this != &that)
 			{
 				_tid = that._tid;
 				_str = that._str;
+				_frame = that._frame;
 				_val = that._val;
 				_when = that._when;
 			}
@@ -196,6 +201,7 @@ protected:
 	};
 
 	f8_concurrent_queue<LogElement> _msg_queue;
+	WaitStrategy _wait;
 	unsigned _sequence, _osequence;
 
 	typedef std::
@@ -233,9 +239,31 @@ public:
 	bool send(const std::string& what, const unsigned val=0)
 	{
 		const LogElement le(pthread_self(), what, val);
-		return _msg_queue.try_push (le) == 0;
+		const bool result(_msg_queue.try_push (le) == 0);
+		_wait.notify();
+		return result;
 	}
 
+	/*! Log an encoded message frame. The frame buffer is shared, not copied.
+	    \param what the frame to log
+	    \param val optional value for the logger to use
+	    \return true on success */
+	bool send(const OutboundFrame& what, const unsigned val=0)
+	{
+		const LogElement le(pthread_self(), what, val);
+		const bool result(_msg_queue.try_push (le) == 0);
+		_wait.notify();
+		return result;
+	}
+
+	/*! Set what the logging thread does when its queue is empty. May be changed while running.
+	    \param wait wait strategy */
+	void set_wait_strategy(const WaitStrategy& wait) { _wait = wait; }
+
+	/*! Set the placement and scheduling policy for the logging thread; applied immediately.
+	    \param policy thread policy */
+	void set_thread_policy(const ThreadPolicy& policy) { _thread.set_policy(policy); }
+
 	/// Stop the logging thread.
 	void stop() { send(std::string()); _stopping = true; _thread.join(); }
 
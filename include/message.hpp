@@ -49,6 +49,7 @@ namespace FIX8 {
 class MessageBase;
 class Message;
 class Session;
+struct BaseMsgEntry;
 typedef std::vector<MessageBase *> GroupElement;
 
 //-------------------------------------------------------------------------------------------------
@@ -67,19 +68,31 @@ class GroupBase
 	unsigned short _fnum;
 	/// vector of repeating messagebase groups
 	GroupElement _msgs;
+	/// empty group element used for its field traits by the streaming decoder
+	mutable MessageBase *_proto;
 
 public:
 	/*! ctor
 	    \param fnum number of fields in this group */
-	GroupBase(const unsigned short fnum) : _fnum(fnum) {}
+	GroupBase(const unsigned short fnum) : _fnum(fnum), _proto() {}
 
 	/// dtor
-	virtual ~GroupBase() { clear(false); }
+	virtual ~GroupBase();
 
 	/*! Create a new group element.
 	  \return new message */
 	virtual MessageBase *create_group() const = 0;
 
+	/*! Get an empty group element, created on first use. Never has fields added; shared by all decoders
+	    using this group definition.
+	  \return pointer to prototype element */
+	const MessageBase *prototype() const
+	{
+		if (!_proto)
+			_proto = create_group();
+		return _proto;
+	}
+
 	/*! Add a message to a repeating group
 	  \param what message to add */
 	void add(MessageBase *what) { _msgs.push_back(what); }
@@ -129,6 +142,44 @@ public:
 	virtual bool operator()(const Message *msg) const { return false; }
 };
 
+//-------------------------------------------------------------------------------------------------
+/// Callback interface for the streaming decoder (Message::decode with a visitor). Fields are presented
+/// in wire order, directly from the source buffer; no Message or field objects are constructed.
+class MessageVisitor
+{
+public:
+	/// Dtor.
+	virtual ~MessageVisitor() {}
+
+	/*! Called once the message type is known, before any field is presented.
+	    \param mtype message type
+	    \param bme generated metadata for this message type
+	    \return false to skip the rest of the message */
+	virtual bool on_message_begin(const f8String& mtype, const BaseMsgEntry& bme) { return true; }
+
+	/*! Called for each field, including group count fields and fields within groups.
+	    \param tag field tag
+	    \param value field value, valid only for the duration of the call */
+	virtual void on_field(const unsigned short tag, const FieldValue& value) = 0;
+
+	/*! Called after the count field of a repeating group.
+	    \param tag group count field tag (no...)
+	    \param count number of repeats declared */
+	virtual void on_group_begin(const unsigned short tag, const unsigned count) {}
+
+	/*! Called at the start of each group repeat.
+	    \param tag group count field tag (no...)
+	    \param inst repeat index, from 0 */
+	virtual void on_group_instance(const unsigned short tag, const unsigned inst) {}
+
+	/*! Called after the last field of the last group repeat.
+	    \param tag group count field tag (no...) */
+	virtual void on_group_end(const unsigned short tag) {}
+
+	/// Called after the checksum has been validated.
+	virtual void on_message_end() {}
+};
+
 //-------------------------------------------------------------------------------------------------
 /// Structure for framework generated message creation table
 struct BaseMsgEntry
@@ -190,10 +241,75 @@ public:
 };
 #endif
 
+//-------------------------------------------------------------------------------------------------
+/// Pool of decoded messages of a single type, held for reuse by Message::factory
+class MsgPool
+{
+	std::vector<Message *> _msgs;
+	f8_mutex _mutex;
+
+public:
+	/// Ctor.
+	MsgPool() {}
+
+	/// Dtor. Deletes all pooled messages.
+	~MsgPool();
+
+	/*! Take a message from the pool.
+	    \return pointer to message or 0 if pool is empty */
+	Message *get()
+	{
+		f8_scoped_lock guard(_mutex);
+		if (_msgs.empty())
+			return 0;
+		Message *msg(_msgs.back());
+		_msgs.pop_back();
+		return msg;
+	}
+
+	/*! Put a message into the pool.
+	    \param msg message to pool; must have been cleared
+	    \param maxsz maximum number of messages to hold
+	    \return true if pooled, false if the pool is full */
+	bool put(Message *msg, const size_t maxsz)
+	{
+		f8_scoped_lock guard(_mutex);
+		if (_msgs.size() >= maxsz)
+			return false;
+		_msgs.push_back(msg);
+		return true;
+	}
+};
+
 //-------------------------------------------------------------------------------------------------
 typedef GeneratedTable<const f8String, BaseMsgEntry> MsgTable;
 typedef GeneratedTable<unsigned, BaseEntry> FieldTable;
 
+/// Framework generated hash tables for O(1) message type and field tag lookup.
+/*! Message types of up to 4 characters are packed into an integer key; (key * _msg_mult) >> _msg_shift
+    is collision free for all generated message types. Field tags index _fld_index directly. */
+struct MetaHash
+{
+	unsigned _msg_mult, _msg_shift;
+	/// slot to message table index + 1, 0 if empty
+	const unsigned short *_msg_slots;
+	/// tag to field table index + 1, 0 if not a generated field
+	const unsigned short *_fld_index;
+	unsigned _fld_index_sz;
+
+	/*! Pack a message type into a hash key.
+	    \param from message type
+	    \param len length of message type, no more than 4
+	    \return key */
+	static unsigned msg_key(const char *from, const size_t len)
+	{
+		unsigned key(0);
+		for (size_t ii(0); ii < len; ++ii)
+			key = key << 8 | static_cast<unsigned char>(from[ii]);
+		return key;
+	}
+};
+
 /// Static metadata context class - one per FIX xml schema
 struct F8MetaCntx
 {
@@ -212,49 +328,346 @@ struct F8MetaCntx
 	/// Fix header beginstring
 	const f8String _beginStr;
 
-	enum MsgFlags { noverifychksum, count };
+	/// noverifychksum: skip inbound checksum verification; lazydecode: only construct fields when first accessed
+	enum MsgFlags { noverifychksum, lazydecode, count };
 	mutable ebitset<MsgFlags, unsigned> _msg_flags;
 	bool has_flag(MsgFlags flg) const { return _msg_flags.has(flg); }
 	void set_flag(MsgFlags flg) { _msg_flags.set(flg); }
 	void clear_flag(MsgFlags flg) { _msg_flags.set(flg, false); }
 
-	F8MetaCntx(const unsigned version, const MsgTable& bme, const FieldTable& be, const f8String& bg)
+	/// Inbound message pools, one per message type, indexed as _bme
+	MsgPool *_msg_pool;
+	/// Maximum number of messages held in each pool; 0 (the default) disables pooling
+	size_t _msg_pool_max;
+
+	/// Framework generated table of pre-rendered tag prefixes, indexed by tag
+	const TagPrefix *_tag_prefix;
+	const unsigned _tag_prefix_sz;
+
+	/*! Get the pre-rendered encode prefix for a tag.
+	    \param fnum field tag
+	    \return pointer to prefix or 0 if not available */
+	const TagPrefix *tag_prefix(const unsigned short fnum) const { return fnum < _tag_prefix_sz ? _tag_prefix + fnum : 0; }
+
+	/// Framework generated message type and field tag hash tables
+	const MetaHash *_hash;
+
+	/// Empty message per message type, indexed as _bme; read only field traits for the streaming decoder
+	mutable f8_atomic<Message **> _protos;
+	mutable f8_mutex _protos_mutex;
+
+	/*! Get the prototype message for a message type. All prototypes are created on first use.
+	    \param bmp pointer to the message table entry for this type
+	    \return pointer to the prototype */
+	const Message *prototype(const MsgTable::Pair *bmp) const
+	{
+		Message **protos(_protos);
+		return (protos ? protos : build_prototypes())[msg_index(bmp)];
+	}
+
+	/*! Create the prototype messages for all message types.
+	    \return pointer to prototype table */
+	Message **build_prototypes() const;
+
+	/*! Find the message table entry for a message type.
+	    \param mtype message type
+	    \param len length of message type
+	    \return pointer to the entry or 0 if not found */
+	const MsgTable::Pair *find_msg(const char *mtype, const size_t len) const
+	{
+		if (!_hash || len > 4)
+			return _bme.find_pair_ptr(f8String(mtype, len));
+		const unsigned short slot(_hash->_msg_slots[(MetaHash::msg_key(mtype, len) * _hash->_msg_mult) >> _hash->_msg_shift]);
+		const MsgTable::Pair *bmp(slot ? _bme.begin() + slot - 1 : 0);
+		return bmp && bmp->_key.size() == len && ::memcmp(bmp->_key.data(), mtype, len) == 0 ? bmp : 0;
+	}
+
+	/*! Find the message table entry for a message type.
+	    \param mtype message type
+	    \return pointer to the entry or 0 if not found */
+	const MsgTable::Pair *find_msg(const f8String& mtype) const { return find_msg(mtype.data(), mtype.size()); }
+
+	/*! Get the message table index of a message table entry; used to index per message type tables.
+	    \param bmp pointer to the entry
+	    \return index */
+	unsigned msg_index(const MsgTable::Pair *bmp) const { return bmp - _bme.begin(); }
+
+	/*! Find the field table entry for a field tag.
+	    \param tag field tag
+	    \return pointer to the entry or 0 if not found */
+	const BaseEntry *find_be(const unsigned tag) const
+	{
+		if (!_hash)
+			return _be.find_ptr(tag);
+		return tag < _hash->_fld_index_sz && _hash->_fld_index[tag] ? &(_be.begin() + _hash->_fld_index[tag] - 1)->_value : 0;
+	}
+
+	/*! Set the maximum number of messages held in each message type pool. Pooling is off by default; an
+	    application opts in before starting its sessions, eg. TEX::ctx.set_msg_pool_max(8). Only enable it if
+	    inbound messages are not retained after the session handler returns.
+	    \param maxsz maximum; 0 disables inbound message pooling */
+	void set_msg_pool_max(const size_t maxsz) { _msg_pool_max = maxsz; }
+
+	/*! Get the message pool for a message type.
+	    \param bmp pointer to the message table entry for this type
+	    \return reference to the pool */
+	MsgPool& get_msg_pool(const MsgTable::Pair *bmp) const { return _msg_pool[msg_index(bmp)]; }
+
+	F8MetaCntx(const unsigned version, const MsgTable& bme, const FieldTable& be, const f8String& bg,
+		const TagPrefix *tag_prefix=0, const unsigned tag_prefix_sz=0, const MetaHash *hash=0)
 		: _version(version), _bme(bme), _be(be),
 #if defined PERMIT_CUSTOM_FIELDS
 		_ube(),
 #endif
 		_mk_hdr(_bme.find_ptr("header")->_create), _mk_trl(_bme.find_ptr("trailer")->_create),
-		_beginStr(bg) {}
+		_beginStr(bg), _msg_pool(new MsgPool[_bme.size()]), _msg_pool_max(),
+		_tag_prefix(tag_prefix), _tag_prefix_sz(tag_prefix ? tag_prefix_sz : 0), _hash(hash) { _protos = 0; }
+
+	/// Dtor.
+	~F8MetaCntx();
 
 	/// 4 digit fix version <Major:1><Minor:1><Revision:2> eg. 4.2r10 is 4210
 	unsigned version() const { return _version; }
 };
 
 //-------------------------------------------------------------------------------------------------
-typedef std::map<unsigned short, BaseField *> Fields;
-#if 0 // defined HAS_TR1_UNORDERED_MAP
-typedef std::tr1::unordered_map <unsigned short, BaseField *> Fields;
-#endif
+/// Per message type sets of body fields to construct on decode (selective decode). Fields outside the set
+/// are tokenised and skipped; repeating group count fields are always constructed so group boundaries are found.
+class FieldInterest
+{
+public:
+	/// Field tags of interest for one message type, indexed by tag
+	typedef std::vector<bool> TagSet;
+
+private:
+	const F8MetaCntx& _ctx;
+	/// indexed as the message table; empty if all fields are wanted
+	std::vector<TagSet> _by_type;
+
+public:
+	/*! Ctor.
+	    \param ctx reference to generated metadata */
+	FieldInterest(const F8MetaCntx& ctx) : _ctx(ctx), _by_type(ctx._bme.size()) {}
+
+	/*! Add a field to the interest set of a message type. Throws InvalidMetadata if the message type is unknown.
+	    \param mtype message type
+	    \param tag field tag */
+	void add(const f8String& mtype, const unsigned short tag)
+	{
+		const MsgTable::Pair *bmp(_ctx.find_msg(mtype));
+		if (!bmp)
+			throw InvalidMetadata(mtype);
+		TagSet& tags(_by_type[_ctx.msg_index(bmp)]);
+		if (tag >= tags.size())
+			tags.resize(tag + 1);
+		tags[tag] = true;
+	}
+
+	/*! Add fields to the interest set of a message type.
+	    \tparam InputIterator input iterator type
+	    \param mtype message type
+	    \param begin first tag
+	    \param end one past the last tag */
+	template<typename InputIterator>
+	void add(const f8String& mtype, InputIterator begin, const InputIterator end)
+	{
+		for (; begin != end; ++begin)
+			add(mtype, *begin);
+	}
+
+	/*! Get the interest set of a message type.
+	    \param bmp pointer to the message table entry for this type
+	    \return pointer to the set or 0 if all fields are wanted */
+	const TagSet *find(const MsgTable::Pair *bmp) const
+	{
+		const TagSet& tags(_by_type[_ctx.msg_index(bmp)]);
+		return tags.empty() ? 0 : &tags;
+	}
+
+	/*! Check if a field is in an interest set.
+	    \param tags interest set
+	    \param tag field tag
+	    \return true if wanted */
+	static bool wants(const TagSet& tags, const unsigned short tag) { return tag < tags.size() && tags[tag]; }
+};
+
+//-------------------------------------------------------------------------------------------------
+/// Flat field storage; one slot per field position (FieldTrait::_pos - 1), 0 if the field is not present.
+/// Iterating the slots visits present fields in encode order.
+typedef std::vector<BaseField *> Fields;
+
+/*! Iterator over the fields present in a message, source compatible with the iterators of the former
+    std::map<unsigned short, BaseField *> field container: it dereferences to a (tag, field) pair and skips
+    empty slots. Note that fields are now visited in schema position order (the order they are encoded),
+    not in tag order; likewise a decoded message re-encodes in schema order rather than arrival order. */
+class FieldsIterator
+{
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef std::pair<unsigned short, BaseField *> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const value_type *pointer;
+	typedef const value_type& reference;
+
+private:
+	Fields::const_iterator _itr, _end;
+	value_type _val;
+
+	/// Advance to the next present field.
+	void skip()
+	{
+		while (_itr != _end && !*_itr)
+			++_itr;
+		if (_itr != _end)
+			_val = value_type((*_itr)->get_tag(), *_itr);
+	}
 
-typedef std::multimap<unsigned short, BaseField *> Positions;
+public:
+	/*! Ctor.
+	    \param itr first slot
+	    \param end last slot + 1 */
+	FieldsIterator(Fields::const_iterator itr, Fields::const_iterator end) : _itr(itr), _end(end), _val() { skip(); }
+
+	reference operator*() const { return _val; }
+	pointer operator->() const { return &_val; }
+	FieldsIterator& operator++() { ++_itr; skip(); return *this; }
+	FieldsIterator operator++(int) { FieldsIterator tmp(*this); ++*this; return tmp; }
+	bool operator==(const FieldsIterator& that) const { return _itr == that._itr; }
+	bool operator!=(const FieldsIterator& that) const { return _itr != that._itr; }
+
+	/*! Get the underlying field slot.
+	    \return slot iterator */
+	Fields::const_iterator slot() const { return _itr; }
+};
 
 /// Base class for all fix messages
 class MessageBase
 {
 protected:
-	Fields _fields;
+	/// Location in the raw message of a field that has been decoded but not yet constructed (lazy decode).
+	struct RawField
+	{
+		unsigned _offset;
+		unsigned short _fnum;
+		unsigned _len, _vlen;	// _len is the whole tag=value element including separator
+	};
+	typedef std::vector<RawField> RawFields;
+
 	FieldTraits _fp;
-	Positions _pos;
+	mutable Fields _fields;
+	mutable RawFields _raw;
+	const char *_rawbuf;
+	/// fields to construct on decode (selective decode); 0 for all
+	const FieldInterest::TagSet *_interest;
 	Groups _groups;
 	const f8String& _msgType;
 	const F8MetaCntx& _ctx;
 
-	/*! Extract length and message type from a header buffer
+	/*! Check if a field slot holds a field that has not been constructed yet.
+	    \param idx slot index (position - 1)
+	    \return true if raw */
+	bool is_raw(const unsigned idx) const { return idx < _raw.size() && _raw[idx]._len; }
+
+	/*! Construct the field for a raw slot from the retained message buffer.
+	    \param idx slot index (position - 1)
+	    \return pointer to the constructed field */
+	BaseField *materialise(const unsigned idx) const;
+
+	/// Construct the fields for all raw slots.
+	void materialise_all() const
+	{
+		for (unsigned idx(0); idx < _raw.size(); ++idx)
+			if (_raw[idx]._len)
+				materialise(idx);
+	}
+
+	/*! Record a decoded field without constructing it.
+	    \param fnum field tag
+	    \param itr hint iterator
+	    \param offset offset of the tag=value element in the retained message buffer
+	    \param len length of the element including separator
+	    \param vlen length of the value */
+	void add_raw(const unsigned short fnum, Presence::const_iterator itr, const unsigned offset, const unsigned len, const unsigned vlen)
+	{
+		const unsigned short fpos(_fp.getPos(fnum, itr));
+		if (!fpos)
+			throw InvalidField(fnum);
+		if (_raw.size() < _fields.size())
+			_raw.resize(_fields.size());
+		RawField& rf(_raw[fpos - 1]);
+		rf._offset = offset;
+		rf._fnum = fnum;
+		rf._len = len;
+		rf._vlen = vlen;
+		_fp.set(fnum, itr, FieldTrait::present);
+	}
+
+	/*! Decode fields with a decoder generated by f8c for this message type (f8c --decoders). Decodes from offset
+	    until a field not in this message is found. The default implementation decodes nothing.
+	    \param from source buffer
+	    \param sz size of source buffer
+	    \param offset in bytes to decode from; updated to the offset following the last field decoded
+	    \param idx optional tag/value index of source buffer
+	    \return true if decoding is complete, false if the table driven decoder should continue from offset */
+	virtual bool decode_specialised(const char *from, const unsigned sz, unsigned& offset, FieldIndex *idx) { return false; }
+
+	/*! Encode fields with an encoder generated by f8c for this message type (f8c --encoders). The default
+	    implementation encodes nothing.
+	    \param to buffer to encode to
+	    \param sz current size of buffer payload stream
+	    \return true if encoded, false if the table driven encoder must be used */
+	virtual bool encode_specialised(char *to, size_t& sz) const { return false; }
+
+	/*! Check if a field being decoded by a generated decoder is already present.
+	    \param fnum field tag
+	    \param itr trait of field
+	    \return true if present and automatic (the decoded value is ignored); throws DuplicateField if present otherwise */
+	bool decoded_present(const unsigned short fnum, Presence::const_iterator itr) const
+	{
+		if (!_fp.get(fnum, itr, FieldTrait::present))
+			return false;
+		if (!_fp.get(fnum, itr, FieldTrait::automatic))
+			throw DuplicateField(fnum);
+		return true;
+	}
+
+	/*! Complete a generated decode.
+	    \param tv tag of the field that ended the decode, 0 if the end of the buffer was reached
+	    \param seen bitmask (by trait index) of fields decoded
+	    \param mandatory bitmask (by trait index) of mandatory fields
+	    \return true if decoding is complete, false if the table driven decoder should continue (unknown custom field) */
+	bool decoded_end(const unsigned tv, const unsigned long long seen, const unsigned long long mandatory) const;
+
+	/// Throw MissingMandatoryField if any mandatory field is not present.
+	void check_missing() const;
+
+	/*! Present fields to a visitor, from offset until a field not in this message is found.
+	    \param from source buffer
+	    \param sz size of source buffer
+	    \param offset in bytes to visit from
+	    \param idx tag/value index of source buffer
+	    \param vis visitor to present fields to
+	    \return offset following the last field presented */
+	unsigned visit(const char *from, const unsigned sz, const unsigned offset, FieldIndex& idx, MessageVisitor& vis) const;
+
+	/*! Present the repeats of a repeating group to a visitor.
+	    \param fnum repeating group fix field num (no...)
+	    \param count number of repeats declared
 	    \param from source buffer
+	    \param sz size of source buffer
+	    \param offset in bytes to visit from
+	    \param idx tag/value index of source buffer
+	    \param vis visitor to present fields to
+	    \return offset following the last field presented */
+	unsigned visit_group(const unsigned short fnum, const unsigned count, const char *from, const unsigned sz,
+		const unsigned offset, FieldIndex& idx, MessageVisitor& vis) const;
+
+	/*! Extract length and message type from a header buffer
+	    \param idx tag/value index of source buffer
 	    \param len length to extract to
 	    \param mtype message type to extract to
 	    \return number of bytes consumed */
-	static unsigned extract_header(const f8String& from, f8String& len, f8String& mtype);
+	static unsigned extract_header(FieldIndex& idx, unsigned& len, f8String& mtype);
 
 	/*! Extract chksum from a trailer buffer
 	    \param from source buffer
@@ -276,7 +689,7 @@ public:
 #else
 		, const FieldTrait_Hash_Array *ftha) : _fp(begin, cnt, ftha),
 #endif
-		_msgType(msgType), _ctx(ctx) {}
+		_fields(_fp.max_pos()), _rawbuf(), _interest(), _msgType(msgType), _ctx(ctx) {}
 
 	/// Copy ctor.
 	MessageBase(const MessageBase& from);
@@ -290,15 +703,20 @@ public:
 	    \param reuse if true clear vector */
 	virtual void clear(bool reuse=true)
 	{
-		std::for_each (_fields.begin(), _fields.end(), free_ptr<Delete2ndPairObject<> >());
-		std::for_each (_groups.begin(), _groups.end(), free_ptr<Delete2ndPairObject<> >());
+		std::for_each (_fields.begin(), _fields.end(), free_ptr<>());
 		if (reuse)
 		{
-			_fields.clear();
-			//_groups.clear();
+			std::fill(_fields.begin(), _fields.end(), static_cast<BaseField *>(0));
+			if (!_raw.empty())
+				std::fill(_raw.begin(), _raw.end(), RawField());
+			_rawbuf = 0;
+			_interest = 0;
+			for (Groups::iterator itr(_groups.begin()); itr != _groups.end(); ++itr)
+				itr->second->clear();	// keep the group definitions, empty the repeats
 			_fp.clear_flag(FieldTrait::present);
-			_pos.clear();
 		}
+		else
+			std::for_each (_groups.begin(), _groups.end(), free_ptr<Delete2ndPairObject<> >());
 	}
 
 	/*! Get the number of possible fields in this message
@@ -309,14 +727,26 @@ public:
 	    \param from source string
 	    \param offset in bytes to decode from
 	    \return number of bytes consumed */
-	unsigned decode(const f8String& from, const unsigned offset);
+	unsigned decode(const f8String& from, const unsigned offset) { return decode(from.data(), from.size(), offset); }
+
+	/*! Decode from buffer. Zero copy; fields are constructed directly from the source buffer. If an interest set
+	    has been applied, only fields in the set (and group count fields) are constructed and mandatory fields are
+	    not checked.
+	    \param from source buffer
+	    \param sz size of source buffer
+	    \param offset in bytes to decode from
+	    \param idx optional tag/value index of source buffer; if 0 fields are tokenized as they are decoded
+	    \return number of bytes consumed */
+	unsigned decode(const char *from, const unsigned sz, const unsigned offset, FieldIndex *idx=0);
 
-	/*! Decode repeating group from string.
+	/*! Decode repeating group from buffer.
 	    \param fnum repeating group fix field num (no...)
-	    \param from source string
+	    \param from source buffer
+	    \param sz size of source buffer
 	    \param offset in bytes to decode from
+	    \param idx optional tag/value index of source buffer
 	    \return number of bytes consumed */
-	unsigned decode_group(const unsigned short fnum, const f8String& from, const unsigned offset);
+	unsigned decode_group(const unsigned short fnum, const char *from, const unsigned sz, const unsigned offset, FieldIndex *idx=0);
 
 	/*! Encode message to stream.
 	    \param to stream to encode to
@@ -369,7 +799,7 @@ public:
 	/*! Add fix field to this message.
 	    \param fnum field tag
 		 \param itr hint iterator: set to itr of found element
-	    \param pos position of field in message
+	    \param pos position of field in message; ignored, the field slot is taken from the field traits
 	    \param what pointer to field
 	    \param check if false, don't check for presence */
 	void add_field(const unsigned short fnum, Presence::const_iterator itr, const unsigned pos, BaseField *what, bool check)
@@ -381,30 +811,29 @@ public:
 			return;
 		}
 
-		_fields.insert(Fields::value_type(fnum, what));
-		_pos.insert(Positions::value_type(pos, what));
+		unsigned short fpos(_fp.getPos(fnum, itr));
+		if (!fpos)
+		{
+			if (itr == _fp.get_presence().end())
+				throw InvalidField(fnum);
+			// a trait added without a position is given the next free slot; the trait table may be copied
+			_fp.set_pos(fnum, fpos = _fields.size() + 1);
+			_fields.resize(fpos, 0);
+			itr = _fp.get_presence().end();
+		}
+		if (is_raw(fpos - 1))
+			_raw[fpos - 1]._len = 0;
+		_fields[fpos - 1] = what;
 		_fp.set(fnum, itr, FieldTrait::present);
 	}
 
 	/*! Add fix field to this message.
 	    \param fnum field tag
-	    \param pos position of field in message
+	    \param pos position of field in message; ignored, the field slot is taken from the field traits
 	    \param what pointer to field
 	    \param check if false, don't check for presence */
 	void add_field(const unsigned short fnum, const unsigned pos, BaseField *what, bool check=true)
-	{
-		Presence::const_iterator itr(_fp.get_presence().end());
-		if (check && _fp.get(fnum, itr, FieldTrait::present)) // for now, silently replace duplicate
-		{
-			//std::cerr << _msgType << " replacing field:" << fnum << std::endl;
-			delete replace(fnum, itr, what);
-			return;
-		}
-
-		_fields.insert(Fields::value_type(fnum, what));
-		_pos.insert(Positions::value_type(pos, what));
-		_fp.set(fnum, itr, FieldTrait::present);
-	}
+		{ add_field(fnum, _fp.get_presence().end(), pos, what, check); }
 
 	/*! Set field attribute to given value.
 	    \param field tag number
@@ -444,12 +873,12 @@ public:
 	template<typename T>
 	bool get(T& to) const
 	{
-		Fields::const_iterator fitr(_fields.find(to._fnum));
-		if (fitr == _fields.end())
+		BaseField *fld(get_field(to._fnum));
+		if (!fld)
 			return false;
-		to.set(fitr->second->from<T>().get());
-		if (fitr->second->_rlm)
-			to._rlm = fitr->second->_rlm;
+		to.set(fld->from<T>().get());
+		if (fld->_rlm)
+			to._rlm = fld->_rlm;
 		return true;
 	}
 
@@ -465,8 +894,8 @@ public:
 	template<typename T>
 	const T *get() const
 	{
-		Fields::const_iterator fitr(_fields.find(T::get_field_id()));
-		return fitr == _fields.end() ? 0 : &fitr->second->from<T>();
+		BaseField *fld(get_field(T::get_field_id()));
+		return fld ? &fld->from<T>() : 0;
 	}
 
 	/*! Populate supplied field with value from message.
@@ -489,25 +918,30 @@ public:
 
 	/*! Check if a field is present in this message.
 	    \param fnum field number
-	    \return iterator to field or Fields::const_iterator::end */
-	Fields::const_iterator find_field(const unsigned short fnum) const { return _fields.find(fnum); }
+	    \return iterator to (tag, field) pair or fields_end() */
+	FieldsIterator find_field(const unsigned short fnum) const
+		{ return get_field(fnum) ? FieldsIterator(_fields.begin() + (_fp.getPos(fnum) - 1), _fields.end()) : fields_end(); }
 
 	/*! Check if a field is present in this message.
 	    \param fnum field number
 	    \return pointer to field or 0 if not found */
 	BaseField *get_field(const unsigned short fnum) const
 	{
-		Fields::const_iterator itr(_fields.find(fnum));
-		return itr != _fields.end() ? itr->second : 0;
+		const unsigned short fpos(_fp.getPos(fnum));
+		if (!fpos)
+			return 0;
+		BaseField *fld(_fields[fpos - 1]);
+		return fld || !is_raw(fpos - 1) ? fld : materialise(fpos - 1);
 	}
 
-	/*! Get an iterator to fields present in this message.
-	    \return iterator to the first field or Fields::const_iterator::end */
-	Fields::const_iterator fields_begin() const { return _fields.begin(); }
+	/*! Get an iterator to the (tag, field) pairs present in this message, in schema position order.
+	    Any lazily decoded fields are constructed first.
+	    \return iterator to the first field or fields_end() */
+	FieldsIterator fields_begin() const { materialise_all(); return FieldsIterator(_fields.begin(), _fields.end()); }
 
 	/*! Get an iterator to fields present in this message.
 	    \return iterator to the last field + 1 */
-	Fields::const_iterator fields_end() const { return _fields.end(); }
+	FieldsIterator fields_end() const { return FieldsIterator(_fields.end(), _fields.end()); }
 
 	/*! Replace a field value with another field value.
 	    \param fnum field number
@@ -548,6 +982,9 @@ public:
 		return gitr != _groups.end() ? gitr->second : 0;
 	}
 
+	/// Create the group prototypes of this message and of any nested groups.
+	void build_group_prototypes() const;
+
 	/*! Add a repeating group at the end of a message group. Assume key is not < last.
 	    \param what pointer to group to add */
 	void append_group(GroupBase *what) { _groups.insert(_groups.end(), Groups::value_type(what->_fnum, what)); }
@@ -570,17 +1007,37 @@ public:
 	    \return position of field */
 	unsigned short getPos(const unsigned short field) const { return _fp.getPos(field); }
 
-	/*! Add a fieldtrait to the message.
+	/*! Add a fieldtrait to the message. If the trait has no position or its position is within the
+	    range already in use (generated positions are dense), it is given the next free position
+	    and so is encoded after the existing fields.
 	    \param what FieldTrait to add
 	    \return true on success */
-	bool add_trait(const FieldTrait& what) { return _fp.add(what); }
+	bool add_trait(const FieldTrait& what)
+	{
+		FieldTrait trt(what);
+		if (!trt._field_traits.has(FieldTrait::position) || trt._pos <= _fp.max_pos())
+		{
+			trt._pos = _fields.size() + 1;
+			trt._field_traits.set(FieldTrait::position);
+		}
+		if (!_fp.add(trt))
+			return false;
+		if (trt._pos > _fields.size())
+			_fields.resize(trt._pos, 0);
+		return true;
+	}
 
 	/*! Add a range of fieldtraits to the message.
 	    \tparam InputIterator input iterator type
 	    \param begin first FieldTrait to add
 	    \param cnt - number of elements in field trait table */
 	template<typename InputIterator>
-	void add_trait(const InputIterator begin, const size_t cnt) { _fp.add(begin, cnt); }
+	void add_trait(const InputIterator begin, const size_t cnt)
+	{
+		for (InputIterator itr(begin); itr != begin + cnt; ++itr)
+			if (!add_trait(*itr))
+				break;
+	}
 
 	/*! Print the message to the specified stream.
 	    \param os refererence to stream to print to
@@ -643,6 +1100,16 @@ public:
 		return 0;
 	}
 
+	/*! Extract a tag/value element from a char buffer. Zero copy version, the value is not copied.
+	    \param from source buffer
+	    \param sz size of string
+	    \param tag decoded tag number
+	    \param val set to point to the value in the source buffer
+	    \param vlen length of value
+	    \return number of bytes consumed */
+	static unsigned extract_element(const char *from, const unsigned sz, unsigned& tag, const char *& val, unsigned& vlen)
+		{ return FieldIndex::extract(from, sz, tag, val, vlen); }
+
 	/*! Extract a tag/value element from a char buffer.
 	    \param from source buffer
 	    \param sz size of string
@@ -714,10 +1181,16 @@ class Message : public MessageBase
 	static codec_timings _encode_timings, _decode_timings;
 #endif
 
+	/// Checksum kernels, selected at startup by cpu capability
+	static unsigned (*_sum_bytes)(const char *, const size_t);
+	static unsigned (*_copy_sum_bytes)(char *, const char *, const size_t);
+
 protected:
 	MessageBase *_header, *_trailer;
 	unsigned _custom_seqnum;
 	bool _no_increment;
+	/// Copy of the inbound message retained for lazy decode; capacity is reused when the message is recycled
+	f8String _rawmsg;
 
 public:
 	/*! Ctor.
@@ -772,14 +1245,64 @@ public:
 	/*! Decode from string.
 	    \param from source string
 	    \return number of bytes consumed */
-	unsigned decode(const f8String& from)
-		{ return _trailer->decode(from, MessageBase::decode(from, _header->decode(from, 0))); }
+	unsigned decode(const f8String& from) { return decode(from.data(), from.size()); }
+
+	/*! Decode from buffer. The buffer is tokenized in a single pass before decoding.
+	    \param from source buffer
+	    \param sz size of source buffer
+	    \return number of bytes consumed */
+	unsigned decode(const char *from, const unsigned sz)
+	{
+		FieldIndex idx(from, sz);
+		return decode(from, sz, idx);
+	}
+
+	/*! Decode from a tokenized buffer.
+	    \param from source buffer
+	    \param sz size of source buffer
+	    \param idx tag/value index of source buffer
+	    \return number of bytes consumed */
+	unsigned decode(const char *from, const unsigned sz, FieldIndex& idx)
+	{
+		if (_ctx.has_flag(F8MetaCntx::lazydecode))
+		{
+			_rawmsg.assign(from, sz);
+			_rawbuf = _header->_rawbuf = _trailer->_rawbuf = _rawmsg.data();
+		}
+		return _trailer->decode(from, sz, MessageBase::decode(from, sz, _header->decode(from, sz, 0, &idx), &idx), &idx);
+	}
+
+	/// Bytes reserved ahead of the body for the back-filled BeginString/BodyLength prefix
+	enum { prefix_reserve = OutboundFrame::prefix_reserve };
 
 	/*! Encode message to stream.
 	    \param to stream to encode to
 	    \return number of bytes encoded */
 	unsigned encode(f8String& to) const;
 
+	/*! Encode message in a single pass into a caller supplied buffer. The body is encoded at offset prefix_reserve,
+	    then the BeginString and BodyLength fields are back-filled right aligned into the gap, so the frame
+	    generally does not start at the beginning of the buffer.
+	    \param to buffer to encode to; must be at least prefix_reserve + MAX_MSG_LENGTH bytes
+	    \param frame set to the first byte of the encoded frame within to
+	    \param hdrblk optional pre-encoded header fields, spliced in after the header
+	    \param hdrlen length of hdrblk
+	    \return number of bytes encoded (the length of frame) */
+	unsigned encode(char *to, char *& frame, const char *hdrblk=0, const size_t hdrlen=0) const;
+
+	/*! Encode message into a shareable outbound frame.
+	    \param to frame to encode to; any previous contents are released
+	    \param hdrblk optional pre-encoded header fields, spliced in after the header
+	    \param hdrlen length of hdrblk
+	    \return number of bytes encoded */
+	unsigned encode(OutboundFrame& to, const char *hdrblk=0, const size_t hdrlen=0) const
+	{
+		char *frame;
+		const unsigned len(encode(to.prepare(), frame, hdrblk, hdrlen));
+		to.set(frame, len);
+		return len;
+	}
+
 	/*! Clone this message. Performs a deep copy.
 	    \return pointer to copy of this message */
 	Message *clone() const;
@@ -802,6 +1325,11 @@ public:
 		if (_trailer)
 			_trailer->clear(reuse);
 		MessageBase::clear(reuse);
+		if (reuse)
+		{
+			_custom_seqnum = 0;
+			_no_increment = false;
+		}
 	}
 
 	/*! Generate a checksum from an encoded buffer.
@@ -810,12 +1338,7 @@ public:
 	    \param len maximum length
 	    \return calculated checknum */
 	static unsigned calc_chksum(const f8String& from, const unsigned offset=0, const int len=-1)
-	{
-		unsigned val(0);
-		const char *eptr(from.c_str() + (len != -1 ? len + offset : from.size() - offset));
-		for (const char *ptr(from.c_str() + offset); ptr < eptr; val += *ptr++);
-		return val % 256;
-	}
+		{ return sum_bytes(from.data() + offset, len != -1 ? len : from.size() - offset) % 256; }
 
 	/*! Generate a checksum from an encoded buffer. ULL version.
 	    \param from char *buffer encoded Fix message
@@ -824,12 +1347,20 @@ public:
 	    \param len maximum length
 	    \return calculated checknum */
 	static unsigned calc_chksum(const char *from, const size_t sz, const unsigned offset=0, const int len=-1)
-	{
-		unsigned val(0);
-		const char *eptr(from + (len != -1 ? len + offset : sz - offset));
-		for (const char *ptr(from + offset); ptr < eptr; val += *ptr++);
-		return val % 256;
-	}
+		{ return sum_bytes(from + offset, len != -1 ? len : sz - offset) % 256; }
+
+	/*! Sum the bytes of a buffer, using the fastest kernel the cpu supports (selected at startup).
+	    \param from source buffer
+	    \param sz number of bytes to sum
+	    \return sum of bytes; take % 256 for a Fix checksum */
+	static unsigned sum_bytes(const char *from, const size_t sz) { return _sum_bytes(from, sz); }
+
+	/*! Copy a buffer and sum its bytes in the same pass, using the fastest kernel the cpu supports.
+	    \param to target buffer
+	    \param from source buffer
+	    \param sz number of bytes to copy and sum
+	    \return sum of bytes */
+	static unsigned copy_sum_bytes(char *to, const char *from, const size_t sz) { return _copy_sum_bytes(to, from, sz); }
 
 	/*! Format a checksum into the required 3 digit, 0 padded string.
 	    \param val checksum value
@@ -845,17 +1376,40 @@ public:
 	    \param ctx reference to metadata object
 	    \param from pointer to raw buffer containing Fix message
 	    \return pointer to newly created Message (which will be a super class of the generated type) */
-	static Message *factory(const F8MetaCntx& ctx, const char *from)
-	{
-		const f8String to(from);
-		return factory(ctx, to);
-	}
+	static Message *factory(const F8MetaCntx& ctx, const char *from) { return factory(ctx, from, ::strlen(from)); }
 
 	/*! Using supplied metatdata context and raw input buffer, decode and create appropriate Fix message
 	    \param ctx reference to metadata object
 	    \param from reference to string raw buffer containing Fix message
+	    \param interest optional per message type sets of body fields to construct; others are skipped
+	    \return pointer to newly created Message (which will be a super class of the generated type) */
+	static Message *factory(const F8MetaCntx& ctx, const f8String& from, const FieldInterest *interest=0)
+		{ return factory(ctx, from.data(), from.size(), interest); }
+
+	/*! Using supplied metatdata context and raw input buffer, decode and create appropriate Fix message.
+	    Zero copy; the message is decoded directly from the supplied buffer.
+	    \param ctx reference to metadata object
+	    \param from pointer to raw buffer containing Fix message
+	    \param sz size of Fix message in buffer
+	    \param interest optional per message type sets of body fields to construct; others are skipped
 	    \return pointer to newly created Message (which will be a super class of the generated type) */
-	static Message *factory(const F8MetaCntx& ctx, const f8String& from);
+	static Message *factory(const F8MetaCntx& ctx, const char *from, const size_t sz, const FieldInterest *interest=0);
+
+	/*! Using supplied metatdata context and raw input buffer, decode a Fix message without creating it; each field
+	    is presented to the visitor in wire order as a typed view of the source buffer. Framing, message type and
+	    checksum are validated as for factory; mandatory, duplicate and group count checks are not performed.
+	    \param ctx reference to metadata object
+	    \param from pointer to raw buffer containing Fix message
+	    \param sz size of Fix message in buffer
+	    \param vis visitor to present fields to
+	    \return number of bytes consumed */
+	static unsigned decode(const F8MetaCntx& ctx, const char *from, const size_t sz, MessageVisitor& vis);
+
+	/*! Return a message created by factory to the inbound message pool of its type, to be reused by
+	    a subsequent factory call. The message is cleared; if the pool is full the message is deleted.
+	    \param ctx reference to metadata object the message was created with
+	    \param msg message to recycle */
+	static void recycle(const F8MetaCntx& ctx, Message *msg);
 
 	/*! Set the custom sequence number. Used to override and suppress automatic seqnum assignment.
 	    \param seqnum the outbound sequence number to use for this message. */
@@ -890,6 +1444,49 @@ public:
 #endif
 };
 
+//-------------------------------------------------------------------------------------------------
+/// Scoped holder for a message created by Message::factory; recycles the message on destruction.
+class scoped_msg
+{
+	const F8MetaCntx& _ctx;
+	Message *_msg;
+
+	/// Copy Ctor. Non-copyable.
+	scoped_msg(const scoped_msg&);
+
+	/// Assignment operator. Non-copyable.
+	void operator=(const scoped_msg&);
+
+public:
+	/*! Ctor.
+	  \param ctx reference to metadata object the message was created with
+	  \param msg pointer to message */
+	scoped_msg(const F8MetaCntx& ctx, Message *msg) : _ctx(ctx), _msg(msg) {}
+
+	/// Dtor. Recycles message.
+	~scoped_msg()
+	{
+		if (_msg)
+			Message::recycle(_ctx, _msg);
+	}
+
+	/*! Member selection operator.
+	  \return pointer to message */
+	Message *operator->() const { return _msg; }
+
+	/*! Dereference operator.
+	  \return reference to message */
+	Message& operator*() const { return *_msg; }
+
+	/*! Get the message pointer.
+	  \return pointer to message */
+	Message *get() const { return _msg; }
+
+	/*! Release ownership of the message; it will not be recycled.
+	  \return pointer to message */
+	Message *release() { Message *tmp(_msg); _msg = 0; return tmp; }
+};
+
 //-------------------------------------------------------------------------------------------------
 
 } // FIX8
@@ -70,6 +70,13 @@ public:
 	    \return true on success */
 	virtual bool put(const unsigned seqnum, const f8String& what) = 0;
 
+	/*! Persist an encoded message frame. The default implementation copies the frame into a string.
+	    \param seqnum sequence number of message
+	    \param what message frame
+	    \return true on success */
+	virtual bool put(const unsigned seqnum, const OutboundFrame& what)
+		{ return put(seqnum, f8String(what.data(), what.size())); }
+
 	/*! Persist a sequence control record.
 	    \param sender_seqnum sequence number of last sent message
 	    \param target_seqnum sequence number of last received message
@@ -110,6 +117,10 @@ public:
 
 	/// Stop the persister thread.
 	virtual void stop() {}
+
+	/*! Set what the persister thread, if any, does when its queue is empty.
+	    \param wait wait strategy */
+	virtual void set_wait_strategy(const WaitStrategy& wait) {}
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -180,10 +191,14 @@ class BDBPersister : public Persister
 	}
 
 	f8_concurrent_queue<KeyDataBuffer> _persist_queue;
+	WaitStrategy _wait;
 
 	bool write(const KeyDataBuffer& what)
 	{
-		return _persist_queue.try_push(what);
+		if (!_persist_queue.try_push(what))
+			return false;
+		_wait.notify();
+		return true;
 	}
 
 public:
@@ -245,6 +260,14 @@ public:
 	/// Stop the persister thread.
 	void stop() { write(KeyDataBuffer()); _thread.join(); }
 
+	/*! Set what the persister thread does when its queue is empty.
+	    \param wait wait strategy */
+	void set_wait_strategy(const WaitStrategy& wait) { _wait = wait; }
+
+	/*! Set the placement and scheduling policy for the persister thread.
+	    \param policy thread policy */
+	void set_thread_policy(const ThreadPolicy& policy) { _thread.set_policy(policy); }
+
 	/*! Persister thread entry point.
 	  \return 0 on success */
 	int operator()();	// write thread
@@ -371,7 +394,20 @@ public:
 	    \param seqnum sequence number of message
 	    \param what message string
 	    \return true on success */
-	virtual bool put(const unsigned seqnum, const f8String& what);
+	virtual bool put(const unsigned seqnum, const f8String& what) { return put(seqnum, what.data(), what.size()); }
+
+	/*! Persist an encoded message frame, writing directly from the shared frame buffer.
+	    \param seqnum sequence number of message
+	    \param what message frame
+	    \return true on success */
+	virtual bool put(const unsigned seqnum, const OutboundFrame& what) { return put(seqnum, what.data(), what.size()); }
+
+	/*! Persist a message from a buffer.
+	    \param seqnum sequence number of message
+	    \param what message buffer
+	    \param sz length of message
+	    \return true on success */
+	bool put(const unsigned seqnum, const char *what, const size_t sz);
 
 	/*! Persist a sequence control record.
 	    \param sender_seqnum sequence number of last sent message
@@ -0,0 +1,165 @@
+//-------------------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+//-------------------------------------------------------------------------------------------------
+#ifndef _FIX8_REACTOR_HPP_
+#define _FIX8_REACTOR_HPP_
+
+//-------------------------------------------------------------------------------------------------
+namespace FIX8
+{
+
+//-------------------------------------------------------------------------------------------------
+/// Event callbacks for a descriptor registered with a Reactor. A handler is never dispatched on
+/// more than one reactor thread at a time.
+class ReactorHandler
+{
+public:
+	/// Dtor.
+	virtual ~ReactorHandler() {}
+
+	/*! Called from a reactor thread when the registered descriptor is readable (or has hung up).
+	    The descriptor is not re-armed until this returns.
+	    \return false to deregister the handler */
+	virtual bool on_readable() = 0;
+
+	/// Called from a reactor thread once every reactor tick; used to service timers.
+	virtual void on_tick() {}
+};
+
+//-------------------------------------------------------------------------------------------------
+/// epoll based reactor. A small pool of threads services read readiness and timer ticks for any
+/// number of registered handlers, replacing the per session reader and timer threads. Writes are not
+/// reactor driven: each connection keeps its writer thread, and a pipelined session its callback thread.
+class Reactor
+{
+	struct Entry
+	{
+		int _fd;
+		bool _busy, _removed, _pending;	// pending: became readable while being ticked
+
+		Entry(const int fd) : _fd(fd), _busy(), _removed(), _pending() {}
+	};
+
+	typedef std::map<ReactorHandler *, Entry> Entries;
+
+	enum { _max_events = 64 };
+
+	int _epfd;
+	unsigned _nthreads, _tick_ms;
+	f8_mutex _mutex;
+	Entries _entries;
+	std::vector<dthread<Reactor> *> _threads;
+	f8_atomic<bool> _stopping;
+	Tickval _next_tick;
+
+	/*! Mark a handler busy prior to dispatch. If it is being ticked, it is marked pending instead and re-armed
+	    when the tick completes.
+	    \param handler handler to dispatch
+	    \return true if the handler is registered and not already being dispatched */
+	bool acquire(ReactorHandler *handler);
+
+	/*! Clear the busy mark after dispatch, re-arming or deregistering the descriptor.
+	    \param handler handler that was dispatched
+	    \param keep if true, re-arm for the next read event, otherwise deregister */
+	void release(ReactorHandler *handler, const bool keep);
+
+	/*! Arm a descriptor for a single read event.
+	    \param fd descriptor
+	    \param handler handler to associate with the event
+	    \param first if true, add the descriptor to the epoll set, otherwise modify it
+	    \return true on success */
+	bool arm(const int fd, ReactorHandler *handler, const bool first=false);
+
+	/// Dispatch on_tick to every registered handler if the tick interval has elapsed.
+	void tick();
+
+	Reactor(const Reactor&);
+	Reactor& operator=(const Reactor&);
+
+public:
+	enum { default_threads = 1, default_tick_ms = 100 };
+
+	/// Ctor. Throws f8Exception if epoll is unavailable.
+	Reactor();
+
+	/// Dtor. Stops and joins the reactor threads.
+	~Reactor();
+
+	/*! Set the number of reactor threads and the tick interval. Has no effect once the reactor
+	    threads have been started.
+	    \param threads number of threads to service events
+	    \param tick_ms interval between on_tick calls in ms
+	    \return true if the configuration was applied */
+	bool configure(const unsigned threads, const unsigned tick_ms=default_tick_ms);
+
+	/*! Register a descriptor for read events. The reactor threads are started on first use.
+	    \param fd descriptor to monitor
+	    \param handler callback object
+	    \return true on success */
+	bool add(const int fd, ReactorHandler *handler);
+
+	/*! Deregister a handler. If the handler is being dispatched on another thread, waits for that
+	    to complete; may be called from within the handler's own callbacks.
+	    \param handler handler to remove
+	    \return true if the handler was registered */
+	bool remove(ReactorHandler *handler);
+
+	/*! Get the number of registered handlers.
+	    \return number of handlers */
+	size_t size() { f8_scoped_lock guard(_mutex); return _entries.size(); }
+
+	/*! Get the number of reactor threads.
+	    \return number of threads */
+	unsigned get_threads() const { return _nthreads; }
+
+	/*! Check if the calling thread is a reactor thread. Code that may run from a handler callback
+	    uses this to avoid blocking the reactor.
+	    \return true if called from a reactor thread */
+	static bool is_reactor_thread();
+
+	/*! Reactor thread entry point.
+	    \return 0 on success */
+	int operator()();
+
+	/*! Get the process wide reactor instance.
+	    \return the reactor */
+	static Reactor *instance() { return Singleton<Reactor>::instance(); }
+};
+
+} // FIX8
+
+#endif // _FIX8_REACTOR_HPP_
+
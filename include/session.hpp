@@ -105,13 +105,13 @@ public:
 	    \return target_comp_id */
 	const f8String& get_id() const { return _id; }
 
-	/*! Targetcompid equivalence operator.
+	/*! Targetcompid equivalence operator; compids are interned so this is normally a pointer comparison.
 	    \return true if both Targetcompids are the same */
-	bool same_sender_comp_id(const target_comp_id& targetCompID) const { return targetCompID() == _senderCompID(); }
+	bool same_sender_comp_id(const target_comp_id& targetCompID) const { return targetCompID.same(_senderCompID); }
 
-	/*! Sendercompid equivalence operator.
+	/*! Sendercompid equivalence operator; compids are interned so this is normally a pointer comparison.
 	    \return true if both Sendercompids are the same */
-	bool same_target_comp_id(const sender_comp_id& senderCompID) const { return senderCompID() == _targetCompID(); }
+	bool same_target_comp_id(const sender_comp_id& senderCompID) const { return senderCompID.same(_targetCompID); }
 
 	/*! Inserter friend.
 	    \param os stream to send to
@@ -152,17 +152,19 @@ struct LoginParameters
 	enum { default_retry_interval=5000, default_login_retries=100 };
 
 	LoginParameters() : _login_retry_interval(default_retry_interval), _login_retries(default_login_retries),
-		_reset_sequence_numbers(), _recv_buf_sz(), _send_buf_sz() {}
+		_reset_sequence_numbers(), _recv_buf_sz(), _send_buf_sz(), _header_template() {}
 
 	LoginParameters(const unsigned login_retry_interval, const unsigned login_retries,
-		const default_appl_ver_id& davi, const bool reset_seqnum=false, unsigned recv_buf_sz=0, unsigned send_buf_sz=0)
+		const default_appl_ver_id& davi, const bool reset_seqnum=false, unsigned recv_buf_sz=0, unsigned send_buf_sz=0,
+		const bool header_template=false)
 		: _login_retry_interval(login_retry_interval), _login_retries(login_retries),
-		_reset_sequence_numbers(reset_seqnum), _davi(davi), _recv_buf_sz(recv_buf_sz), _send_buf_sz(send_buf_sz) {}
+		_reset_sequence_numbers(reset_seqnum), _davi(davi), _recv_buf_sz(recv_buf_sz), _send_buf_sz(send_buf_sz),
+		_header_template(header_template) {}
 
 	LoginParameters(const LoginParameters& from)
 		: _login_retry_interval(from._login_retry_interval), _login_retries(from._login_retries),
 		_reset_sequence_numbers(from._reset_sequence_numbers), _davi(from._davi),
-		_recv_buf_sz(from._recv_buf_sz), _send_buf_sz(from._send_buf_sz) {}
+		_recv_buf_sz(from._recv_buf_sz), _send_buf_sz(from._send_buf_sz), _header_template(from._header_template) {}
 
 	LoginParameters& operator=(const LoginParameters& that)
 	{
@@ -174,6 +176,7 @@ struct LoginParameters
 			_davi = that._davi;
 			_recv_buf_sz = that._recv_buf_sz;
 			_send_buf_sz = that._send_buf_sz;
+			_header_template = that._header_template;
 		}
 		return *this;
 	}
@@ -182,14 +185,101 @@ struct LoginParameters
 	bool _reset_sequence_numbers;
 	default_appl_ver_id _davi;
 	unsigned _recv_buf_sz, _send_buf_sz;
+	bool _header_template;
+};
+
+//-------------------------------------------------------------------------------------------------
+/*! Pre-rendered outbound header block for a session. SenderCompID, TargetCompID and the MsgSeqNum
+    tag are rendered once using the context's tag prefixes; each send patches the MsgSeqNum digits
+    and SendingTime text in place. The date and seconds of SendingTime are only reformatted when
+    the second changes. */
+class HeaderTemplate
+{
+	enum { _sec_len = 17, _max_len = 2 * MAX_FLD_LENGTH + 64 };
+	char _buf[_max_len];
+	size_t _fixed, _len;
+	unsigned _last_sec;
+	char _sec_str[_sec_len + 1];	// YYYYMMDD-HH:MM:SS
+	const TagPrefix *_st_pfx;
+
+	/*! Write a "tag=" prefix, using the pre-rendered prefix if there is one.
+	    \param to target buffer
+	    \param tag field tag
+	    \param pfx pre-rendered prefix or 0
+	    \return number of bytes written */
+	static size_t put_tag(char *to, const unsigned tag, const TagPrefix *pfx);
+
+public:
+	/// Ctor.
+	HeaderTemplate() : _fixed(), _len(), _last_sec(), _st_pfx() {}
+
+	/*! Render the fixed part of the template.
+	    \param ctx metadata context for tag prefixes
+	    \param sid session id supplying the comp ids */
+	void render(const F8MetaCntx& ctx, const SessionID& sid);
+
+	/*! Patch the sequence number and sending time into the template.
+	    \param seqnum MsgSeqNum to write
+	    \param now SendingTime to write
+	    \return length of the header block */
+	size_t patch(const unsigned seqnum, const Tickval& now);
+
+	/// Discard the rendered template; it will be rendered again on next use.
+	void clear() { _fixed = _len = 0; }
+
+	/*! Check if the template has been rendered.
+	    \return true if not rendered */
+	bool empty() const { return _fixed == 0; }
+
+	/*! Get the header block.
+	    \return pointer to the header block */
+	const char *data() const { return _buf; }
+
+	/*! Get the header block length.
+	    \return length of the last patched header block */
+	size_t size() const { return _len; }
 };
 
 //-------------------------------------------------------------------------------------------------
 /// Fix8 Base Session. User sessions derive from this class.
 class Session
 {
-	typedef StaticTable<const f8String, bool (Session::*)(const unsigned, const Message *)> Handlers;
+	typedef bool (Session::*Handler)(const unsigned, const Message *);
+	typedef StaticTable<const f8String, Handler> Handlers;
 	Handlers _handlers;
+	/// Handlers indexed by message table index (see F8MetaCntx::msg_index)
+	std::vector<Handler> _handler_index;
+
+	/// Build the handler index from the handler table.
+	void index_handlers();
+
+	/// Session header fields located in a raw inbound message without building a Message.
+	struct RawHeader
+	{
+		unsigned _seqnum, _msgtype_len, _sender_len, _target_len;
+		const char *_msgtype, *_sender, *_target;
+
+		RawHeader() : _seqnum(), _msgtype_len(), _sender_len(), _target_len(), _msgtype(), _sender(), _target() {}
+	};
+
+	/*! Locate MsgSeqNum, MsgType, SenderCompID and TargetCompID in a raw message with a single scan.
+	    \param from raw fix message
+	    \param hdr target for the extracted fields
+	    \return true if MsgSeqNum was found */
+	static bool scan_header(const f8String& from, RawHeader& hdr);
+
+	/*! Check if a scanned message is of a type handled by handle_application.
+	    \param hdr scanned header fields
+	    \return true if an application message */
+	bool is_application(const RawHeader& hdr) const;
+
+	/*! Enforce session semantics on a message that will be visited rather than built. Compids and
+	    sequence are checked on the scanned header; only a sequence number below the expected one
+	    (a possible resend) needs the header decoded, to check PossDupFlag and OrigSendingTime.
+	    \param hdr scanned header fields
+	    \param from raw fix message
+	    \return true if message FAILS enforce rules */
+	bool enforce(const RawHeader& hdr, const f8String& from);
 
 	/*! Initialise atomic members.
 	  \param st the initial session state */
@@ -211,12 +301,19 @@ protected:
 	struct SessionConfig *_sf;
 
 	LoginParameters _loginParamaters;
+	HeaderTemplate _hdr_tmpl;
 
 	Persister *_persist;
 	Logger *_logger, *_plogger;
+	/// If set, inbound application messages are presented to this visitor instead of being constructed
+	MessageVisitor *_visitor;
+	/// If set, only the body fields in these sets are constructed for inbound messages
+	const FieldInterest *_interest;
 
 	Timer<Session> _timer;
 	TimerEvent<Session> _hb_processor;
+	/// True once the timer thread is running; not started for sessions serviced by a Reactor
+	bool _timer_started;
 
 	/// Heartbeat generation service thread.
 	bool heartbeat_service();
@@ -386,7 +483,22 @@ public:
 	    \return true on success */
 	bool send_process(Message *msg);
 
-	/// stop the session.
+	/*! Process message (encode) and send, taking SenderCompID, TargetCompID, MsgSeqNum and SendingTime
+	    from the session header template instead of adding them to the message header.
+	    \param msg Message
+	    \return true on success */
+	bool send_process_template(Message *msg);
+
+	/*! Write an encoded message to the connection, then protocol log and persist it and advance the
+	    outbound sequence. Shared by send_process and send_process_template.
+	    \param msg the encoded Message
+	    \param output encoded frame
+	    \param enclen encoded length
+	    \param is_dup true if a possible duplicate; duplicates are not persisted and do not advance the sequence
+	    \return true on success */
+	bool send_frame(const Message *msg, const OutboundFrame& output, const unsigned enclen, const bool is_dup);
+
+	/// stop the session. Pauses briefly to let the connection wind down, unless called from a reactor thread.
 	void stop();
 
 	/*! Get the connection object.
@@ -397,6 +509,16 @@ public:
 	    \return the context object */
 	const F8MetaCntx& get_ctx() const { return _ctx; }
 
+	/*! Decode inbound application messages with a streaming visitor (see Message::decode) instead of constructing
+	    them; handle_application is not called. Administrative messages are always constructed and handled as usual.
+	    \param vis visitor to use, not owned by the session; 0 to construct application messages again */
+	void set_visitor(MessageVisitor *vis) { _visitor = vis; }
+
+	/*! Decode inbound messages selectively; for message types with an interest set, only the body fields in the set
+	    (and repeating group count fields) are constructed. Mandatory fields are not checked for those types.
+	    \param interest interest sets to use, not owned by the session; 0 to construct all fields */
+	void set_interest(const FieldInterest *interest) { _interest = interest; }
+
 	/*! Log a message to the session logger.
 	    \param what string to log
 	    \param value optional value for the logger to use
@@ -409,6 +531,12 @@ public:
 	    \return true on success */
 	bool plog(const std::string& what, const unsigned direction=0) const { return _plogger ? _plogger->send(what, direction) : false; }
 
+	/*! Log an encoded message frame to the protocol logger, sharing the frame buffer.
+	    \param what frame to log
+	    \param direction 0=out, 1=in
+	    \return true on success */
+	bool plog(const OutboundFrame& what, const unsigned direction=0) const { return _plogger ? _plogger->send(what, direction) : false; }
+
 	/*! Return the last received timstamp
 	    \return Tickval on success */
 	const Tickval& get_last_received() const { return _last_received; }
@@ -472,6 +600,14 @@ public:
 	    \return true if shutdown is underway */
 	bool is_shutdown() { return _control.has(shutdown); }
 
+	/*! Service elapsed heartbeat and other timer events; called by a Reactor in place of the timer thread.
+	    \return false if the timer has been told to exit */
+	bool service_timer() { return _timer.poll(); }
+
+	/*! Set the placement and scheduling policy for the heartbeat timer thread.
+	    \param policy thread policy */
+	void set_timer_thread_policy(const ThreadPolicy& policy) { _timer.set_thread_policy(policy); }
+
 	/* ! Set the SessionConfig object - only for server sessions
 		\param sf pointer to SessionConfig object */
 	void set_session_config(struct SessionConfig *sf) { _sf = sf; }
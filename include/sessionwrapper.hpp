@@ -59,9 +59,13 @@ struct SessionConfig : public Configuration
 		if (!_ses)
 			throw InvalidConfiguration(session_name);
 
+		const ThreadPolicy global(get_default_thread_policy());
+		if (!global.empty())	// threads without a role of their own, e.g. the global logger if not yet started
+			ThreadPolicy::global() = global;
+
 		LoginParameters lparam(get_retry_interval(_ses), get_retry_count(_ses),
 			get_default_appl_ver_id(_ses), get_reset_sequence_number_flag(_ses),
-			get_tcp_recvbuf_sz(_ses), get_tcp_sendbuf_sz(_ses));
+			get_tcp_recvbuf_sz(_ses), get_tcp_sendbuf_sz(_ses), get_header_template_flag(_ses));
 		_loginParameters = lparam;
 	}
 
@@ -71,6 +75,28 @@ struct SessionConfig : public Configuration
 	/*! Get a pointer to the active session XmlElement to permit extraction of other XML attributes
 	  \return the session element */
 	const XmlElement *get_session_element() const { return _ses; }
+
+	/*! Get the reactor that should service this session's connections.
+	  \return the process wide reactor, or 0 if this session runs its own reader and timer threads */
+	Reactor *get_session_reactor()
+	{
+		if (!get_reactor(_ses))
+			return 0;
+		Reactor *reactor(Reactor::instance());
+		reactor->configure(get_reactor_threads(_ses));
+		return reactor;
+	}
+
+	/*! Apply the session's reactor, outbound batching, wait strategy and thread policy settings to a new connection.
+	  \param cn connection to configure */
+	void configure_connection(Connection& cn)
+	{
+		cn.set_reactor(get_session_reactor());
+		cn.set_write_batch(get_write_batch(_ses), get_write_batch_us(_ses));
+		cn.set_wait_strategies(get_wait_strategy(_ses, "reader"), get_wait_strategy(_ses, "writer"));
+		cn.set_thread_policies(get_thread_policy(_ses, "reader"), get_thread_policy(_ses, "callback"),
+			get_thread_policy(_ses, "writer"));
+	}
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -106,6 +132,9 @@ public:
 		_cc(init_con_later ? 0 : new ClientConnection(_sock, _addr, *_session, get_pipelined(_ses)))
 	{
 		_session->set_login_parameters(_loginParameters);
+		_session->set_timer_thread_policy(get_thread_policy(_ses, "timer"));
+		if (_cc)
+			configure_connection(*_cc);
 	}
 
 	/// Dtor.
@@ -179,6 +208,7 @@ public:
 
 				this->_sock = new Poco::Net::StreamSocket,
 				this->_cc = new ClientConnection(this->_sock, this->_addr, *this->_session, this->get_pipelined(this->_ses));
+				this->configure_connection(*this->_cc);
 				this->_session->start(this->_cc, true, _send_seqnum, _recv_seqnum, this->_loginParameters._davi());
 				_send_seqnum = _recv_seqnum = 0; // only set seqnums for the first time round
 			}
@@ -265,6 +295,8 @@ public:
 	{
 		_session->set_login_parameters(sf._loginParameters);
 		_session->set_session_config(&sf);
+		_session->set_timer_thread_policy(sf.get_thread_policy(sf._ses, "timer"));
+		sf.configure_connection(_sc);
 	}
 
 	/// Dtor.
@@ -40,6 +40,18 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 //----------------------------------------------------------------------------------------
 #include<pthread.h>
 #include<signal.h>
+#include<sched.h>
+#include<errno.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<ctype.h>
+#include<strings.h>
+#include<vector>
+#include<string>
+#if defined __linux__
+#include<unistd.h>
+#include<sys/syscall.h>
+#endif
 
 //----------------------------------------------------------------------------------------
 namespace FIX8
@@ -81,6 +93,188 @@ inline reference_wrapper<T> ref(T& _t) { return reference_wrapper<T>(_t); }
 template<typename T>
 inline reference_wrapper<const T> cref(T& _t) { return reference_wrapper<const T>(_t); }
 
+//----------------------------------------------------------------------------------------
+/// Placement and scheduling for a thread: cpu affinity, scheduling policy and priority, and
+/// preferred NUMA node. An empty policy leaves the thread as created.
+class ThreadPolicy
+{
+	std::vector<unsigned> _cpus;
+	int _sched, _priority, _numa_node;
+
+public:
+#if defined CPU_SETSIZE
+	enum { max_cpus = CPU_SETSIZE };
+#else
+	enum { max_cpus = 1024 };
+#endif
+
+	/// Ctor.
+	ThreadPolicy() : _sched(-1), _priority(), _numa_node(-1) {}
+
+	/*! Set the cpus the thread may run on.
+	  \param cpus cpu list, e.g. "0-3,8"; cpu numbers must be less than max_cpus
+	  \return true if the list was valid */
+	bool set_cpus(const std::string& cpus) { return parse_cpus(cpus, _cpus); }
+
+	/*! Set the scheduling policy and priority.
+	  \param sched policy name: other, batch, idle, fifo or rr
+	  \param priority static priority, only used by fifo and rr
+	  \return true if the policy name was recognised */
+	bool set_sched(const std::string& sched, const int priority=0)
+	{
+		static const struct { const char *_name; int _policy; } policies[] =
+		{
+			{ "other", SCHED_OTHER }, { "fifo", SCHED_FIFO }, { "rr", SCHED_RR },
+#if defined SCHED_BATCH
+			{ "batch", SCHED_BATCH },
+#endif
+#if defined SCHED_IDLE
+			{ "idle", SCHED_IDLE },
+#endif
+		};
+		for (size_t ii(0); ii < sizeof(policies) / sizeof(policies[0]); ++ii)
+		{
+			if (strcasecmp(sched.c_str(), policies[ii]._name) == 0)
+			{
+				_sched = policies[ii]._policy;
+				_priority = _sched == SCHED_FIFO || _sched == SCHED_RR ? priority : 0;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*! Set the preferred NUMA node for memory allocation. If no cpus are set, the thread is also
+	    restricted to the node's cpus.
+	  \param node node number, -1 for none */
+	void set_numa_node(const int node) { _numa_node = node; }
+
+	/*! Get the cpu list.
+	  \return the cpus, empty if not restricted */
+	const std::vector<unsigned>& get_cpus() const { return _cpus; }
+
+	/*! Get the scheduling policy.
+	  \return the policy, -1 if not set */
+	int get_sched() const { return _sched; }
+
+	/*! Get the scheduling priority.
+	  \return the priority */
+	int get_priority() const { return _priority; }
+
+	/*! Get the preferred NUMA node.
+	  \return the node, -1 if not set */
+	int get_numa_node() const { return _numa_node; }
+
+	/*! Check if this policy would change anything.
+	  \return true if empty */
+	bool empty() const { return _cpus.empty() && _sched < 0 && _numa_node < 0; }
+
+	/*! Apply this policy to a thread. Memory placement can only be applied to the calling thread.
+	  \param tid thread to apply to
+	  \param self true if tid is the calling thread
+	  \return 0 on success, otherwise the error from the first setting that failed */
+	int apply(const pthread_t tid, const bool self) const
+	{
+		if (empty())
+			return 0;
+
+		int result(0);
+#if defined __linux__
+		std::vector<unsigned> cpus(_cpus);
+		if (cpus.empty() && _numa_node >= 0)
+		{
+			char path[64];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", _numa_node);
+			if (FILE *fp = fopen(path, "r"))
+			{
+				char buf[256];
+				if (fgets(buf, sizeof(buf), fp))
+					parse_cpus(buf, cpus);
+				fclose(fp);
+			}
+		}
+
+		if (!cpus.empty())
+		{
+			cpu_set_t cset;
+			CPU_ZERO(&cset);
+			for (std::vector<unsigned>::const_iterator itr(cpus.begin()); itr != cpus.end(); ++itr)
+				if (*itr < CPU_SETSIZE)
+					CPU_SET(*itr, &cset);
+			result = pthread_setaffinity_np(tid, sizeof(cset), &cset);
+		}
+
+		if (self && _numa_node >= 0 && _numa_node < 64)
+		{
+			const int mpol_preferred(1);
+			unsigned long nodemask(1UL << _numa_node);
+			if (syscall(SYS_set_mempolicy, mpol_preferred, &nodemask, sizeof(nodemask) * 8 + 1) && !result)
+				result = errno;
+		}
+#else
+		if (!_cpus.empty() || _numa_node >= 0)
+			result = ENOTSUP;
+#endif
+
+		if (_sched >= 0)
+		{
+			sched_param param = {};
+			param.sched_priority = _priority;
+			const int err(pthread_setschedparam(tid, _sched, &param));
+			if (err && !result)
+				result = err;
+		}
+
+		return result;
+	}
+
+	/*! Parse a cpu list of the form "0-3,8,10". Cpu numbers of max_cpus or more are rejected. Whitespace
+	    around entries is ignored, so a blank list parses as empty.
+	  \param from string to parse
+	  \param to target
+	  \return true on success; the target is unchanged on failure */
+	static bool parse_cpus(const std::string& from, std::vector<unsigned>& to)
+	{
+		std::vector<unsigned> result;
+		for (const char *ptr(from.c_str()); *ptr;)
+		{
+			if (isspace(*ptr))	// e.g. the newline ending an empty sysfs cpulist
+			{
+				++ptr;
+				continue;
+			}
+			char *end;
+			const unsigned long first(strtoul(ptr, &end, 10));
+			if (end == ptr || first >= max_cpus)
+				return false;
+			unsigned long last(first);
+			if (*end == '-')
+			{
+				ptr = end + 1;
+				last = strtoul(ptr, &end, 10);
+				if (end == ptr || last < first || last >= max_cpus)
+					return false;
+			}
+			for (unsigned long ii(first); ii <= last; ++ii)
+				result.push_back(ii);
+			while (isspace(*end))
+				++end;
+			if (*end == ',')
+				++end;
+			else if (*end)
+				return false;
+			ptr = end;
+		}
+		to.swap(result);
+		return true;
+	}
+
+	/*! The process wide default, used by threads that have no policy of their own, such as the global
+	    logger, reactor and session timer threads. Set this before those threads are started.
+	  \return reference to the default policy */
+	static ThreadPolicy& global() { static ThreadPolicy _global; return _global; }
+};
+
 //----------------------------------------------------------------------------------------
 /// pthread wrapper abstract base
 class _dthreadcore
@@ -88,24 +282,43 @@ class _dthreadcore
 	pthread_attr_t _attr;
 	pthread_t _tid;
 	int _exitval;
+	ThreadPolicy _policy;
+	bool _has_policy, _running;
+	int _policy_error;
+	mutable pthread_mutex_t _policy_mutex;	// guards the policy fields, set_policy may race with thread startup
+	void *_sub;
 
 	template<typename T>
 	static void *_run(void *what)
-		{ return reinterpret_cast<void *>((*static_cast<T *>(what))()); }
+	{
+		_dthreadcore *core(static_cast<_dthreadcore *>(what));
+		pthread_mutex_lock(&core->_policy_mutex);
+		core->_policy_error = (core->_has_policy ? core->_policy : ThreadPolicy::global()).apply(pthread_self(), true);
+		core->_running = true;
+		pthread_mutex_unlock(&core->_policy_mutex);
+		return reinterpret_cast<void *>((*static_cast<T *>(core->_sub))());
+	}
 
 	_dthreadcore& operator=(const _dthreadcore&);
 
 protected:
 
 	template<typename T>
-	int _start(void *sub) { return pthread_create(&_tid, &_attr, _run<T>, sub); }
+	int _start(void *sub)
+	{
+		_sub = sub;
+		return pthread_create(&_tid, &_attr, _run<T>, this);
+	}
 
 public:
 	/*! Ctor.
 	  \param detach detach thread if true
 	  \param stacksize default thread stacksize */
-	_dthreadcore(const bool detach, const size_t stacksize) throw(dthreadException) : _attr(), _tid(), _exitval()
+	_dthreadcore(const bool detach, const size_t stacksize) throw(dthreadException)
+		: _attr(), _tid(), _exitval(), _has_policy(), _running(), _policy_error(), _sub()
 	{
+		if (pthread_mutex_init(&_policy_mutex, 0))
+			throw dthreadException("pthread_mutex_init failure");
 		if (pthread_attr_init(&_attr))
 			throw dthreadException("pthread_attr_init failure");
 		if (stacksize && pthread_attr_setstacksize(&_attr, stacksize))
@@ -115,12 +328,40 @@ public:
 	}
 
 	/// Dtor.
-	virtual ~_dthreadcore() { pthread_attr_destroy(&_attr); }
+	virtual ~_dthreadcore()
+	{
+		pthread_attr_destroy(&_attr);
+		pthread_mutex_destroy(&_policy_mutex);
+	}
 
 	/*! start thread.
 	  \return function result */
 	virtual int start() = 0;	// ABC
 
+	/*! Set the placement and scheduling policy for this thread, replacing the process wide default. Applied
+	    by the thread when it starts; if it is already running, affinity and scheduling are applied immediately.
+	  \param policy policy to use
+	  \return 0 on success, otherwise the error from applying the policy */
+	int set_policy(const ThreadPolicy& policy)
+	{
+		pthread_mutex_lock(&_policy_mutex);
+		_policy = policy;
+		_has_policy = true;
+		const int result(_running ? _policy_error = _policy.apply(_tid, pthread_equal(_tid, pthread_self())) : 0);
+		pthread_mutex_unlock(&_policy_mutex);
+		return result;
+	}
+
+	/*! Get the result of applying the thread policy.
+	  \return 0 on success, otherwise the error from the first setting that failed */
+	int get_policy_error() const
+	{
+		pthread_mutex_lock(&_policy_mutex);
+		const int result(_policy_error);
+		pthread_mutex_unlock(&_policy_mutex);
+		return result;
+	}
+
 	/*! Join the thread.
 	  \return result of join */
 	int join()
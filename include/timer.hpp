@@ -120,6 +120,15 @@ public:
 	/// Start the timer thread.
 	void start() { _thread.start(); }
 
+	/*! Set the placement and scheduling policy for the timer thread.
+	  \param policy thread policy */
+	void set_thread_policy(const ThreadPolicy& policy) { _thread.set_policy(policy); }
+
+	/*! Service any elapsed timer events from the calling thread, for timers driven by a Reactor
+	  rather than by their own thread.
+	  \return false if an exit event was found or a callback returned false */
+	bool poll();
+
 	/*! Timer thread entry point.
 	  \return result at timer thread exit */
    int operator()();
@@ -172,6 +181,33 @@ int Timer<T>::operator()()
 	return 0;
 }
 
+//-------------------------------------------------------------------------------------------------
+template<typename T>
+bool Timer<T>::poll()
+{
+	for (;;)
+	{
+		f8_scoped_lock guard(_mutex);
+		if (_event_queue.empty())
+			return true;
+
+		const TimerEvent<T>& op(_event_queue.top());
+		if (!op._t) // empty timeval means exit
+		{
+			_event_queue.pop();
+			return false;
+		}
+		if (op._t > Tickval::get_tickval()) // nothing has elapsed
+			return true;
+
+		const TimerEvent<T> rop(op); // take a copy
+		_event_queue.pop();
+		guard.release();
+		if (!(_monitor.*rop._callback)())
+			return false;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 template<typename T>
 size_t Timer<T>::clear()
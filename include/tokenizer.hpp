@@ -0,0 +1,313 @@
+//-------------------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+//-------------------------------------------------------------------------------------------------
+#ifndef _FIX8_TOKENIZER_HPP_
+#define _FIX8_TOKENIZER_HPP_
+
+#if defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+namespace FIX8 {
+
+//-------------------------------------------------------------------------------------------------
+/// Vectorised character scanning. Uses AVX2 or SSE2 when the compiler targets them, otherwise scalar.
+struct simd_scan
+{
+#if defined __AVX2__
+	typedef __m256i vec_type;
+	enum { width = 32 };
+	static vec_type splat(const char what) { return _mm256_set1_epi8(what); }
+	static vec_type load(const char *from) { return _mm256_loadu_si256(reinterpret_cast<const vec_type *>(from)); }
+	static unsigned match(const vec_type& blk, const vec_type& what)
+		{ return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(blk, what))); }
+#elif defined __SSE2__
+	typedef __m128i vec_type;
+	enum { width = 16 };
+	static vec_type splat(const char what) { return _mm_set1_epi8(what); }
+	static vec_type load(const char *from) { return _mm_loadu_si128(reinterpret_cast<const vec_type *>(from)); }
+	static unsigned match(const vec_type& blk, const vec_type& what)
+		{ return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(blk, what))); }
+#else
+	enum { width = 0 };
+#endif
+
+	/*! Find the first occurrence of a character in a buffer.
+	  \param from start of buffer
+	  \param eptr end of buffer
+	  \param what character to find
+	  \return pointer to character or eptr if not found */
+	static const char *find(const char *from, const char *eptr, const char what)
+	{
+#if defined __AVX2__ || defined __SSE2__
+		const vec_type vwhat(splat(what));
+		for (; from + width <= eptr; from += width)
+		{
+			const unsigned mask(match(load(from), vwhat));
+			if (mask)
+				return from + __builtin_ctz(mask);
+		}
+#endif
+		for (; from < eptr; ++from)
+			if (*from == what)
+				return from;
+		return eptr;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+/// Tag/value boundary table for an encoded FIX message.
+/*! The '=' and field separator positions are located with a vectorised scan; decode then walks the table
+    rather than rescanning each field. The table is a small fixed window that is refilled from the next element
+    when decode steps past its end, so the cost on the stack does not depend on the message size. Elements are
+    located by their byte offset so callers can keep working in offsets; any offset not found in the window
+    falls back to the scalar tokenizer. */
+class FieldIndex
+{
+public:
+	enum { window = 64 };
+
+	/// A single tag/value element.
+	struct Element
+	{
+		unsigned _offset, _next, _tag, _vlen;
+		const char *_val;
+	};
+
+private:
+	const char *_from;
+	const unsigned _sz;
+	unsigned _cnt, _cur, _resume;
+	/// true if the window filled before the end of the buffer; tokenizing continues from _resume
+	bool _more;
+	Element _elements[window];
+
+	/*! Record an element; the tag is converted here, it must be all digits.
+	  \param offset start of tag
+	  \param eq offset of '='
+	  \param soh offset of field separator
+	  \return false if the tag is invalid */
+	bool add(const unsigned offset, const unsigned eq, const unsigned soh)
+	{
+		Element& el(_elements[_cnt]);
+		el._tag = 0;
+		for (const char *ptr(_from + offset), *eptr(_from + eq); ptr < eptr; ++ptr)
+		{
+			if (!isdigit(*ptr))
+				return false;
+			el._tag = (el._tag << 3) + (el._tag << 1) + *ptr - '0';
+		}
+		el._offset = offset;
+		el._next = soh + 1;
+		el._val = _from + eq + 1;
+		el._vlen = soh - eq - 1;
+		++_cnt;
+		return true;
+	}
+
+	/*! Record the element ending at a field separator.
+	  \param where offset of field separator
+	  \param start start of current tag; advanced past the separator if the element was recorded
+	  \param eq position of '=' in the current field + 1, or 0 if not yet seen; reset if the element was recorded
+	  \return false if tokenizing should stop */
+	bool separator(const unsigned where, unsigned& start, unsigned& eq)
+	{
+		if (_cnt == window)
+		{
+			_more = true;
+			return false;
+		}
+		if (!eq || !add(start, eq - 1, where))
+			return false;
+		start = where + 1;
+		eq = 0;
+		return true;
+	}
+
+	/*! Process a block of match bits.
+	  \param base offset of the block
+	  \param bits bitmask of '=' and field separator positions in the block
+	  \param eqbits bitmask of '=' positions in the block
+	  \param start start of current tag
+	  \param eq position of '=' in the current field + 1, or 0 if not yet seen
+	  \return false if tokenizing should stop */
+	bool process(const unsigned base, unsigned bits, const unsigned eqbits, unsigned& start, unsigned& eq)
+	{
+		while (bits)
+		{
+			const unsigned bit(__builtin_ctz(bits)), where(base + bit);
+			bits &= bits - 1;
+			if (eqbits & 1U << bit)
+			{
+				if (!eq)	// first '=' ends the tag, others are part of the value
+					eq = where + 1;
+			}
+			else if (!separator(where, start, eq))
+				return false;
+		}
+		return true;
+	}
+
+	/*! Fill the window with the elements starting at a byte offset.
+	  \param offset byte offset of the first element */
+	void tokenize(unsigned offset)
+	{
+		unsigned start(offset), eq(0);	// eq is stored +1 so 0 means not seen
+		_cnt = _cur = 0;
+		_more = false;
+#if defined __AVX2__ || defined __SSE2__
+		const simd_scan::vec_type veq(simd_scan::splat('=')), vsoh(simd_scan::splat(default_field_separator));
+		for (; offset + simd_scan::width <= _sz; offset += simd_scan::width)
+		{
+			const simd_scan::vec_type blk(simd_scan::load(_from + offset));
+			const unsigned eqbits(simd_scan::match(blk, veq));
+			if (!process(offset, eqbits | simd_scan::match(blk, vsoh), eqbits, start, eq))
+			{
+				_resume = start;
+				return;
+			}
+		}
+#endif
+		for (; offset < _sz; ++offset)
+		{
+			if (_from[offset] == '=')
+			{
+				if (!eq)
+					eq = offset + 1;
+			}
+			else if (_from[offset] == static_cast<char>(default_field_separator) && !separator(offset, start, eq))
+				break;
+		}
+		_resume = start;
+	}
+
+public:
+	/*! Ctor. Tokenize the start of the supplied buffer.
+	  \param from source buffer
+	  \param sz size of source buffer */
+	FieldIndex(const char *from, const unsigned sz) : _from(from), _sz(sz), _cnt(), _cur(), _resume(), _more() { tokenize(0); }
+
+	/*! Get the number of elements in the current window.
+	  \return number of elements */
+	unsigned size() const { return _cnt; }
+
+	/*! Get an element of the current window by index.
+	  \param idx index of element
+	  \return reference to element */
+	const Element& operator[](const unsigned idx) const { return _elements[idx]; }
+
+	/*! Find the element starting at a byte offset; checks the current and next elements before searching.
+	    Stepping to the element following the window refills the window from there.
+	  \param offset byte offset of element
+	  \return pointer to element or 0 if not found */
+	const Element *find(const unsigned offset)
+	{
+		if (_more && offset == _resume)
+			tokenize(offset);
+		if (_cur < _cnt && _elements[_cur]._offset == offset)
+			return _elements + _cur;
+		if (_cur + 1 < _cnt && _elements[_cur + 1]._offset == offset)
+			return _elements + ++_cur;
+		unsigned lo(0), hi(_cnt);
+		while (lo < hi)
+		{
+			const unsigned mid((lo + hi) / 2);
+			if (_elements[mid]._offset < offset)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo < _cnt && _elements[lo]._offset == offset)
+			return _elements + (_cur = lo);
+		return 0;
+	}
+
+	/*! Extract the tag/value element at a byte offset. Falls back to the scalar tokenizer if the offset
+	    is not at a known element boundary.
+	  \param offset byte offset of element
+	  \param tag decoded tag number
+	  \param val set to point to the value in the source buffer
+	  \param vlen length of value
+	  \return number of bytes consumed, 0 if no element */
+	unsigned extract(const unsigned offset, unsigned& tag, const char *& val, unsigned& vlen)
+	{
+		const Element *el(find(offset));
+		if (el)
+		{
+			tag = el->_tag;
+			val = el->_val;
+			vlen = el->_vlen;
+			return el->_next - el->_offset;
+		}
+		return offset < _sz ? extract(_from + offset, _sz - offset, tag, val, vlen) : 0;
+	}
+
+	/*! Extract a tag/value element from a char buffer. Zero copy scalar version, the value is not copied.
+	    \param from source buffer
+	    \param sz size of string
+	    \param tag decoded tag number
+	    \param val set to point to the value in the source buffer
+	    \param vlen length of value
+	    \return number of bytes consumed */
+	static unsigned extract(const char *from, const unsigned sz, unsigned& tag, const char *& val, unsigned& vlen)
+	{
+		tag = 0;
+		for (unsigned ii(0); ii < sz; ++ii)
+		{
+			if (!isdigit(from[ii]))
+			{
+				if (from[ii] != '=')
+					return 0;
+				val = from + ++ii;
+				const char *eptr(simd_scan::find(val, from + sz, default_field_separator));
+				if (eptr == from + sz)
+					return 0;
+				vlen = eptr - val;
+				return eptr - from + 1;
+			}
+			tag = (tag << 3) + (tag << 1) + from[ii] - '0';
+		}
+		return 0;
+	}
+};
+
+} // FIX8
+
+#endif // _FIX8_TOKENIZER_HPP_
+
@@ -142,26 +142,54 @@ struct FieldTrait
 };
 
 //-------------------------------------------------------------------------------------------------
+/// Per field bitset words, indexed by the position of a trait in its (sorted) trait table.
+typedef unsigned long long TraitBits;
+enum { trait_bits_per_word = 64 };
+
+/*! Get the number of bitset words needed for a number of traits.
+  \param els number of traits
+  \return number of words */
+inline unsigned trait_words(const size_t els) { return (els + trait_bits_per_word - 1) / trait_bits_per_word; }
+
+//-------------------------------------------------------------------------------------------------
+/// Lookup and mask tables shared by all instances of a generated message or group.
 struct FieldTrait_Hash_Array
 {
    const unsigned _els, _sz;
    unsigned short *_arr;
+	/// schema mandatory and suppress masks, trait_words(_els) each
+	TraitBits *_masks;
+	/// highest field position in the table, the number of field slots a message needs
+	unsigned short _max_pos;
 
    FieldTrait_Hash_Array(const FieldTrait *from, const size_t els)
-      : _els(els), _sz((from + _els - 1)->_fnum + 1), _arr(new unsigned short [_sz])
+      : _els(els), _sz((from + _els - 1)->_fnum + 1), _arr(new unsigned short [_sz]), _masks(new TraitBits[2 * trait_words(_els)]),
+		_max_pos()
    {
 		for (unsigned ii(0); ii < _sz; _arr[ii++] = 0)
 			;
+		std::fill(_masks, _masks + 2 * trait_words(_els), 0);
       for (unsigned offset(0); offset < _els; ++offset)
+		{
          _arr[from[offset]._fnum] = offset;
+			const TraitBits bit(1ULL << offset % trait_bits_per_word);
+			if (from[offset]._field_traits.has(FieldTrait::mandatory))
+				_masks[offset / trait_bits_per_word] |= bit;
+			if (from[offset]._field_traits.has(FieldTrait::suppress))
+				_masks[trait_words(_els) + offset / trait_bits_per_word] |= bit;
+			if (from[offset]._field_traits.has(FieldTrait::position) && from[offset]._pos > _max_pos)
+				_max_pos = from[offset]._pos;
+		}
    }
 
-   ~FieldTrait_Hash_Array() { delete[] _arr; }
+   ~FieldTrait_Hash_Array() { delete[] _arr; delete[] _masks; }
 };
 
 //-------------------------------------------------------------------------------------------------
 /// Specialisation of Presorted set using hash array lookup
 /// Search complexity is O(1), ctor complexity approaches O(1), no insert
+/// When constructed from a generated trait table the table is shared, not copied; the set takes a private copy
+/// on the first insert.
 template<>
 class presorted_set<unsigned short, FieldTrait, FieldTrait::Compare>
 {
@@ -187,32 +215,77 @@ private:
 	size_t _sz, _rsz;
 	FieldTrait *_arr;
 	const FieldTrait_Hash_Array *_ftha;
+	/// true if _arr was allocated by this set, false if it is a shared generated table
+	bool _owner;
 
 	typedef std::pair<iterator, iterator> internal_result;
 	typedef std::pair<const_iterator, const_iterator> const_internal_result;
 
+	/// Replace a shared table with a private copy, with reserve.
+	void own()
+	{
+		FieldTrait *new_arr(new FieldTrait[_rsz = _sz + calc_reserve(_sz, _reserve)]);
+		memcpy(new_arr, _arr, _sz * sizeof(FieldTrait));
+		_arr = new_arr;
+		_ftha = 0;
+		_owner = true;
+	}
+
 public:
-	/*! ctor - initialise from static sorted set
-	  \param arr_start pointer to start of static array to copy elements from
-	  \param sz number of elements in set to copy
+	/*! ctor - share a static sorted set
+	  \param arr_start pointer to start of static array
+	  \param sz number of elements in set
 	  \param ftha pointer to field hash array
-	  \param reserve percentage of sz to keep in reserve */
+	  \param reserve percentage of sz to keep in reserve, if a private copy is taken */
 	presorted_set(const_iterator arr_start, const size_t sz, const FieldTrait_Hash_Array *ftha, const size_t reserve=RESERVE_PERCENT)
-		: _reserve(reserve), _sz(sz), _rsz(_sz + calc_reserve(_sz, _reserve)), _arr(new FieldTrait[_rsz]), _ftha(ftha)
-			{ memcpy(_arr, arr_start, _sz * sizeof(FieldTrait)); }
+		: _reserve(reserve), _sz(sz), _rsz(_sz), _arr(const_cast<FieldTrait *>(arr_start)), _ftha(ftha), _owner() {}
 
 	presorted_set(const_iterator arr_start, const size_t sz, const size_t reserve=RESERVE_PERCENT) : _reserve(reserve),
-		_sz(sz), _rsz(_sz + calc_reserve(_sz, _reserve)), _arr(new FieldTrait[_rsz]), _ftha()
-			{ memcpy(_arr, arr_start, _sz * sizeof(FieldTrait)); }
+		_sz(sz), _rsz(_sz), _arr(const_cast<FieldTrait *>(arr_start)), _ftha(), _owner() {}
 
 	/*! ctor - initialise an empty set; defer memory allocation;
 	  \param sz number of elements to initially allocate
 	  \param reserve percentage of sz to keep in reserve */
 	explicit presorted_set(const size_t sz=0, const size_t reserve=RESERVE_PERCENT) : _reserve(reserve),
-		_sz(sz), _rsz(_sz + calc_reserve(_sz, _reserve)), _arr(), _ftha() {}
+		_sz(sz), _rsz(_sz + calc_reserve(_sz, _reserve)), _arr(), _ftha(), _owner(true) {}
+
+	/*! copy ctor - a shared table remains shared, a private table is copied
+	  \param from set to copy */
+	presorted_set(const presorted_set& from) : _reserve(from._reserve), _sz(from._sz), _rsz(from._rsz),
+		_arr(from._arr), _ftha(from._ftha), _owner()
+	{
+		if (from._owner)
+		{
+			_owner = true;
+			if (_arr)
+			{
+				_arr = new FieldTrait[_rsz];
+				memcpy(_arr, from._arr, _sz * sizeof(FieldTrait));
+			}
+		}
+	}
 
 	/// dtor
-	~presorted_set() { delete[] _arr; }
+	~presorted_set()
+	{
+		if (_owner)
+			delete[] _arr;
+	}
+
+	/*! Check if this set shares a generated table.
+	  \return true if shared */
+	bool is_shared() const { return !_owner; }
+
+	/// Take a private copy of a shared table so its elements can be modified; element order is unchanged.
+	void unshare()
+	{
+		if (!_owner)
+			own();
+	}
+
+	/*! Get the field hash array, if any.
+	  \return pointer to hash array or 0 */
+	const FieldTrait_Hash_Array *get_ftha() const { return _ftha; }
 
 	/*! Find an element with the given value
 	  \param what element to find
@@ -277,12 +350,18 @@ public:
 	{
 		if (!_sz)
 		{
-			_arr = new FieldTrait[_rsz];
+			if (_owner)
+				delete[] _arr;
+			_arr = new FieldTrait[_rsz = calc_reserve(0, _reserve) + 1];
+			_ftha = 0;
+			_owner = true;
 			memcpy(_arr, what, sizeof(FieldTrait));
 			++_sz;
 			return result(_arr, true);
 		}
 
+		if (!_owner)
+			own();
 		bool answer;
 		iterator where(find(*what, answer));
 		if (answer) // sorry already here
@@ -303,6 +382,7 @@ public:
 			memcpy(new_arr + wptr + 1, where, (end() - where) * sizeof(FieldTrait));
 			delete[] _arr;
 			_arr = new_arr;
+			where = _arr + wptr;
 		}
 		++_sz;
 		return result(where, true);
@@ -355,16 +435,94 @@ public:
 	/*! Get a const pointer to the last element + 1
 	  \return the last element + 1 */
 	const_iterator end() const { return _arr + _sz; }
+
+private:
+	presorted_set& operator=(const presorted_set&);
 };
 
 //-------------------------------------------------------------------------------------------------
 typedef presorted_set<unsigned short, FieldTrait, FieldTrait::Compare> Presence;
 
 /// A collection of FieldTraits for a message. Which fields are required, which are present.
+/*! The trait table is the generated schema table, shared by all instances. The traits that vary per instance
+    (present, suppress) are held in bitsets indexed by trait position, with a copy of the schema mandatory mask so
+    that missing fields are found a word at a time. Traits changed on a private (non generated) table are also
+    recorded in the table itself. */
 class FieldTraits
 {
 	Presence _presence;
 
+	enum { inline_words = 2, bit_sets = 3 };
+	/// present, suppress and mandatory bitsets of _words each; held inline for up to 128 fields
+	TraitBits _inline[bit_sets * inline_words];
+	TraitBits *_bits;
+	unsigned _words;
+	/// highest field position; taken from the shared table, or found once when the traits are loaded
+	unsigned short _max_pos;
+
+	/*! Get the bitset for a trait held per instance.
+	  \param type trait
+	  \return bitset or 0 if this trait is only held in the trait table */
+	TraitBits *bitset(const FieldTrait::TraitTypes type) const
+	{
+		switch (type)
+		{
+		case FieldTrait::present: return _bits;
+		case FieldTrait::suppress: return _bits + _words;
+		case FieldTrait::mandatory: return _bits + 2 * _words;
+		default: return 0;
+		}
+	}
+
+	/*! Size the bitsets for a number of words, preserving current bits.
+	  \param words number of words per bitset */
+	void resize_bits(const unsigned words);
+
+	/// Load the suppress and mandatory bitsets from the trait table and clear the present bitset.
+	void init_bits();
+
+	/*! Get the index of a trait.
+	  \param itr iterator to trait
+	  \return index */
+	size_t index(Presence::const_iterator itr) const { return Presence::distance(_presence.begin(), itr); }
+
+	/*! Check a trait by index.
+	  \param itr iterator to trait
+	  \param type TraitType to check
+	  \return true if field has trait */
+	bool test(Presence::const_iterator itr, const FieldTrait::TraitTypes type) const
+	{
+		const TraitBits *bs(bitset(type));
+		if (!bs)
+			return itr->_field_traits.has(type);
+		const size_t idx(index(itr));
+		return bs[idx / trait_bits_per_word] & 1ULL << idx % trait_bits_per_word;
+	}
+
+	/*! Set or clear a trait by index.
+	  \param itr iterator to trait
+	  \param type TraitType to change
+	  \param on true to set, false to clear */
+	void assign(Presence::const_iterator itr, const FieldTrait::TraitTypes type, const bool on)
+	{
+		TraitBits *bs(bitset(type));
+		if (bs)
+		{
+			const size_t idx(index(itr));
+			if (on)
+				bs[idx / trait_bits_per_word] |= 1ULL << idx % trait_bits_per_word;
+			else
+				bs[idx / trait_bits_per_word] &= ~(1ULL << idx % trait_bits_per_word);
+		}
+		if (!bs || !_presence.is_shared())	// never modify the generated table
+		{
+			if (on)
+				itr->_field_traits.set(type);
+			else
+				itr->_field_traits.clear(type);
+		}
+	}
+
 public:
 	/*! Ctor.
 	  \tparam InputIterator input iterator to construct from
@@ -374,12 +532,26 @@ public:
 	FieldTraits(const InputIterator begin, const size_t cnt
 
 #if defined PERMIT_CUSTOM_FIELDS
-			) : _presence(begin, cnt) {}
+			) : _presence(begin, cnt), _bits(_inline), _words(), _max_pos() { init_bits(); }
 #else
-		, const FieldTrait_Hash_Array *ftha) : _presence(begin, cnt, ftha) {}
+		, const FieldTrait_Hash_Array *ftha) : _presence(begin, cnt, ftha), _bits(_inline), _words(), _max_pos() { init_bits(); }
 #endif
 	/// Ctor.
-	FieldTraits() {}
+	FieldTraits() : _bits(_inline), _words(), _max_pos() {}
+
+	/// Copy Ctor.
+	FieldTraits(const FieldTraits& from) : _presence(from._presence), _bits(_inline), _words(), _max_pos(from._max_pos)
+	{
+		resize_bits(from._words);
+		std::copy(from._bits, from._bits + bit_sets * _words, _bits);
+	}
+
+	/// Dtor.
+	~FieldTraits()
+	{
+		if (_bits != _inline)
+			delete[] _bits;
+	}
 
 	/*! Check if a field is present
 	  \param field to check
@@ -407,7 +579,20 @@ public:
 	unsigned getval(const unsigned short field)
 	{
 		Presence::const_iterator itr(_presence.find(field));
-		return itr != _presence.end() ? itr->_field_traits.get() : 0;
+		return itr != _presence.end() ? getval(itr) : 0;
+	}
+
+	/*! Get the traits for a field, including those held per instance.
+	  \param itr iterator to trait
+	  \return traits as an unsigned short */
+	unsigned getval(Presence::const_iterator itr) const
+	{
+		unsigned val(itr->_field_traits.get() & ~(1 << FieldTrait::present | 1 << FieldTrait::suppress));
+		if (test(itr, FieldTrait::present))
+			val |= 1 << FieldTrait::present;
+		if (test(itr, FieldTrait::suppress))
+			val |= 1 << FieldTrait::suppress;
+		return val;
 	}
 
 	/*! Get the number of possible fields
@@ -421,7 +606,7 @@ public:
 	bool get(const unsigned short field, FieldTrait::TraitTypes type=FieldTrait::present) const
 	{
 		Presence::const_iterator itr(_presence.find(field));
-		return itr != _presence.end() ? itr->_field_traits.has(type) : false;
+		return itr != _presence.end() ? test(itr, type) : false;
 	}
 
 	/*! Check if a field has a specified trait.
@@ -432,9 +617,9 @@ public:
 	bool get(const unsigned short field, Presence::const_iterator& itr, FieldTrait::TraitTypes type) const
 	{
 		if (itr != _presence.end())
-			return itr->_field_traits.has(type);
+			return test(itr, type);
 		itr = _presence.find(field);
-		return itr != _presence.end() ? itr->_field_traits.has(type) : false;
+		return itr != _presence.end() ? test(itr, type) : false;
 	}
 
 	/*! Find the first field that does not have the specified trait.
@@ -442,8 +627,16 @@ public:
 	  \return field number of field, 0 if none */
 	unsigned short find_missing(FieldTrait::TraitTypes type=FieldTrait::mandatory) const
 	{
+		if (type == FieldTrait::mandatory)	// mandatory & ~present, a word at a time
+		{
+			const TraitBits *mandatory(bitset(FieldTrait::mandatory)), *present(bitset(FieldTrait::present));
+			for (unsigned ww(0); ww < _words; ++ww)
+				if (const TraitBits missing = mandatory[ww] & ~present[ww])
+					return (_presence.begin() + ww * trait_bits_per_word + __builtin_ctzll(missing))->_fnum;
+			return 0;
+		}
 		for (Presence::const_iterator itr(_presence.begin()); itr != _presence.end(); ++itr)
-			if ((itr->_field_traits & type) && (itr->_field_traits & FieldTrait::present) == 0)
+			if (test(itr, type) && !test(itr, FieldTrait::present))
 				return itr->_fnum;
 		return 0;
 	}
@@ -458,10 +651,10 @@ public:
 		{
 			itr = _presence.find(field);
 			if (itr != _presence.end())
-				itr->_field_traits.set(type);
+				assign(itr, type, true);
 		}
 		else
-			itr->_field_traits.set(type);
+			assign(itr, type, true);
 	}
 
 	/*! Set a trait for a specified field.
@@ -469,9 +662,9 @@ public:
 	  \param type TraitType to set (default present) */
 	void set(const unsigned short field, FieldTrait::TraitTypes type=FieldTrait::present)
 	{
-		Presence::iterator itr(_presence.find(field));
+		Presence::const_iterator itr(_presence.find(field));
 		if (itr != _presence.end())
-			itr->_field_traits.set(type);
+			assign(itr, type, true);
 	}
 
 	/*! Clear a trait for a specified field.
@@ -484,10 +677,10 @@ public:
 		{
 			itr = _presence.find(field);
 			if (itr != _presence.end())
-				itr->_field_traits.clear(type);
+				assign(itr, type, false);
 		}
 		else
-			itr->_field_traits.clear(type);
+			assign(itr, type, false);
 	}
 
 	/*! Clear a trait for a specified field.
@@ -495,26 +688,37 @@ public:
 	  \param type TraitType to set (default present) */
 	void clear(const unsigned short field, FieldTrait::TraitTypes type=FieldTrait::present)
 	{
-		Presence::iterator itr(_presence.find(field));
+		Presence::const_iterator itr(_presence.find(field));
 		if (itr != _presence.end())
-			itr->_field_traits.clear(type);
+			assign(itr, type, false);
 	}
 
-	/*! Add a FieldTrait.
+	/*! Add a FieldTrait. The first add to a shared trait table takes a private copy of the table.
 	  \param what TraitType to add
 	  \return true on success (false already present) */
-	bool add(const FieldTrait& what) { return _presence.insert(&what).second; }
+	bool add(const FieldTrait& what);
 
 	/*! Add from a range of traits.
 	  \param begin start iterator to input
 	  \param cnt number of elements to input */
 	template<typename InputIterator>
-	void add(const InputIterator begin, const size_t cnt) { _presence.insert(begin, begin + cnt); }
+	void add(const InputIterator begin, const size_t cnt)
+	{
+		for (InputIterator itr(begin); itr != begin + cnt; ++itr)
+			if (!add(*itr))
+				break;
+	}
 
 	/*! Clear a trait from all traits.
 	  \param type TraitType to clear */
 	void clear_flag(FieldTrait::TraitTypes type=FieldTrait::present)
-		{ for (Presence::const_iterator itr(_presence.begin()); itr != _presence.end(); itr++->_field_traits.clear(type)); }
+	{
+		TraitBits *bs(bitset(type));
+		if (bs)
+			std::fill(bs, bs + _words, 0);
+		if (!bs || !_presence.is_shared())
+			for (Presence::const_iterator itr(_presence.begin()); itr != _presence.end(); itr++->_field_traits.clear(type));
+	}
 
 	/*! Check if a specified field has the present bit set (is present).
 	  \param field field to check
@@ -542,6 +746,11 @@ public:
 	  \return true if a component */
 	bool is_component(const unsigned short field) const { return get(field, FieldTrait::component); }
 
+	/*! Check if the field at a trait index is suppressed; used by generated encoders.
+	  \param idx trait index
+	  \return true if suppressed */
+	bool is_suppressed(const size_t idx) const { return test(_presence.begin() + idx, FieldTrait::suppress); }
+
 	/*! Get the field position of a specified field.
 	  \param field field to get
 	  \param itr hint iterator: if end, set to itr of found element, if not end use it to locate element
@@ -563,6 +772,16 @@ public:
 		return itr != _presence.end() && itr->_field_traits.has(FieldTrait::position) ? itr->_pos : 0;
 	}
 
+	/*! Set the position of a field that has none (or move it). A shared table is copied first.
+	  \param field field to set
+	  \param pos new position
+	  \return true on success, false if the field is not in this set */
+	bool set_pos(const unsigned short field, const unsigned short pos);
+
+	/*! Get the highest field position in this set; generated positions are dense so this is the number of field slots a message needs.
+	  \return highest position, 0 if none */
+	unsigned short max_pos() const { return _max_pos; }
+
 	/*! Get the Presence set
 	  \return the Presence set */
 	const Presence& get_presence() const { return _presence; }
@@ -572,6 +791,9 @@ public:
 	    \param what FieldTraits
 	    \return stream */
 	friend std::ostream& operator<<(std::ostream& os, const FieldTraits& what);
+
+private:
+	FieldTraits& operator=(const FieldTraits&);
 };
 
 } // FIX8
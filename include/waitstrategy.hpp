@@ -0,0 +1,213 @@
+//-------------------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+//-------------------------------------------------------------------------------------------------
+#ifndef _FIX8_WAITSTRATEGY_HPP_
+#define _FIX8_WAITSTRATEGY_HPP_
+
+#include <sched.h>
+#if defined __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+namespace FIX8 {
+
+//-------------------------------------------------------------------------------------------------
+/// What a queue consumer thread does when its queue is empty. One instance per consumer; producers
+/// call notify() after each push so that parked consumers are woken.
+class WaitStrategy
+{
+public:
+	/// spin: busy-spin with pause; yield: spin then sched_yield; park: spin then sleep on a futex with
+	/// a timeout; block: use the queue's blocking pop (TBB), or sleep on a futex until notified (FF).
+	enum Strategy { ws_spin, ws_yield, ws_park, ws_block, ws_count };
+	enum { default_spins = 1000, default_park_us = 1000, block_park_us = 100000 };
+
+private:
+	Strategy _strategy;
+	unsigned _spins, _park_us, _idle;
+	volatile int _seq, _waiters;
+	int _seen;
+
+	/// Pause the cpu in a spin loop.
+	static void relax()
+	{
+#if defined __i386__ || defined __x86_64__
+		__asm__ __volatile__("pause" ::: "memory");
+#else
+		__asm__ __volatile__("" ::: "memory");
+#endif
+	}
+
+	/*! Sleep until notified or the timeout expires. Returns immediately if notified since the last pop.
+	    \param us timeout in us */
+	void park(const unsigned us)
+	{
+		__sync_fetch_and_add(&_waiters, 1);
+#if defined __linux__
+		timespec ts = { us / 1000000, (us % 1000000) * 1000 };
+		syscall(SYS_futex, const_cast<int *>(&_seq), FUTEX_WAIT_PRIVATE, _seen, &ts, 0, 0);
+#else
+		if (_seq == _seen)
+			hypersleep<h_microseconds>(us);
+#endif
+		__sync_fetch_and_sub(&_waiters, 1);
+		_seen = _seq;
+	}
+
+public:
+	/*! Ctor.
+	    \param strategy what to do when idle
+	    \param spins number of idle spins before yielding or parking
+	    \param park_us park timeout in us */
+	explicit WaitStrategy(const Strategy strategy=ws_block, const unsigned spins=default_spins,
+		const unsigned park_us=default_park_us)
+		: _strategy(strategy), _spins(spins), _park_us(park_us ? park_us : static_cast<unsigned>(default_park_us)),
+		_idle(), _seq(), _waiters(), _seen() {}
+
+	/*! Copy Ctor. Copies the policy only.
+	    \param from object to copy */
+	WaitStrategy(const WaitStrategy& from)
+		: _strategy(from._strategy), _spins(from._spins), _park_us(from._park_us), _idle(), _seq(), _waiters(), _seen() {}
+
+	/*! Assignment operator. Copies the policy only; may be used while the consumer is running.
+	    \param that object to copy
+	    \return reference to this object */
+	WaitStrategy& operator=(const WaitStrategy& that)
+	{
+		if (this != &that)
+		{
+			_spins = that._spins;
+			_park_us = that._park_us;
+			_strategy = that._strategy;
+		}
+		return *this;
+	}
+
+	/*! Get the strategy.
+	    \return the strategy */
+	Strategy get_strategy() const { return _strategy; }
+
+	/// Called by the consumer after a successful pop.
+	void reset() { _idle = 0; _seen = _seq; }
+
+	/// Called by the consumer after an unsuccessful pop.
+	void idle()
+	{
+		switch (_strategy)
+		{
+		case ws_spin:
+			relax();
+			break;
+		case ws_yield:
+			if (_idle < _spins)
+			{
+				++_idle;
+				relax();
+			}
+			else
+				sched_yield();
+			break;
+		case ws_park:
+			if (_idle < _spins)
+			{
+				++_idle;
+				relax();
+			}
+			else
+				park(_park_us);
+			break;
+		default:
+			park(block_park_us);
+			break;
+		}
+	}
+
+	/// Called by a producer after a push. Wakes a parked consumer.
+	void notify()
+	{
+		__sync_fetch_and_add(&_seq, 1);
+#if defined __linux__
+		if (_waiters)
+			syscall(SYS_futex, const_cast<int *>(&_seq), FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#endif
+	}
+
+	/*! Pop from a queue, waiting according to the strategy if empty.
+	    \tparam Q queue type
+	    \tparam T target type
+	    \param queue queue to pop from
+	    \param target location to pop to
+	    \return true if an element was popped; false after one idle step */
+	template<typename Q, typename T>
+	bool pop(Q& queue, T& target)
+	{
+#if (MPMC_SYSTEM == MPMC_TBB)
+		if (_strategy == ws_block)
+		{
+			queue.pop(target); // will block
+			return true;
+		}
+#endif
+		if (queue.try_pop(target))
+		{
+			reset();
+			return true;
+		}
+		idle();
+		return false;
+	}
+
+	/*! Get the strategy from its name; case insensitive.
+	    \param from name (spin, yield, park or block)
+	    \param def value to return if not recognised
+	    \return the strategy */
+	static Strategy get_strategy(const std::string& from, const Strategy def=ws_block)
+	{
+		static const char *names[ws_count] = { "spin", "yield", "park", "block" };
+		for (int ii(0); ii < ws_count; ++ii)
+			if (from % names[ii])
+				return static_cast<Strategy>(ii);
+		return def;
+	}
+};
+
+} // FIX8
+
+#endif // _FIX8_WAITSTRATEGY_HPP_
+
@@ -119,6 +119,8 @@ Persister *Configuration::create_persister(const XmlElement *from, const Session
 		if (type == "bdb")
 		{
 			scoped_ptr<BDBPersister> result(new BDBPersister);
+			result->set_wait_strategy(get_wait_strategy(from, "persister"));
+			result->set_thread_policy(get_thread_policy(from, "persister"));
 			if (result->initialise(dir, db))
 				return result.release();
 		}
@@ -150,22 +152,30 @@ Logger *Configuration::create_logger(const XmlElement *from, const Logtype ltype
 			{
 				string logname("logname_not_set.log");
 				trim(get_logname(which, logname, sid));
+				Logger *result(0);
 
 				if (logname[0] == '|' || logname[0] == '!')
-					return new PipeLogger(logname, get_logflags(which));
-
-				RegMatch match;
-				if (_ipexp.SearchString(match, logname, 3) == 3)
+					result = new PipeLogger(logname, get_logflags(which));
+				else
 				{
-					f8String ip, port;
-					_ipexp.SubExpr(match, logname, ip, 0, 1);
-					_ipexp.SubExpr(match, logname, port, 0, 2);
-					BCLogger *bcl(new BCLogger(ip, GetValue<unsigned>(port), get_logflags(which)));
-					if (*bcl)
-						return bcl;
+					RegMatch match;
+					if (_ipexp.SearchString(match, logname, 3) == 3)
+					{
+						f8String ip, port;
+						_ipexp.SubExpr(match, logname, ip, 0, 1);
+						_ipexp.SubExpr(match, logname, port, 0, 2);
+						BCLogger *bcl(new BCLogger(ip, GetValue<unsigned>(port), get_logflags(which)));
+						if (*bcl)
+							result = bcl;
+					}
+
+					if (!result)
+						result = new FileLogger(logname, get_logflags(which), get_logfile_rotation(which));
 				}
 
-				return new FileLogger(logname, get_logflags(which), get_logfile_rotation(which));
+				result->set_wait_strategy(get_wait_strategy(from, "logger"));
+				result->set_thread_policy(get_thread_policy(from, "logger"));
+				return result;
 			}
 		}
 	}
@@ -173,6 +183,40 @@ Logger *Configuration::create_logger(const XmlElement *from, const Logtype ltype
 	return 0;
 }
 
+//-------------------------------------------------------------------------------------------------
+WaitStrategy Configuration::get_wait_strategy(const XmlElement *from, const string& role) const
+{
+	string name;
+	if (!from || !(from->GetAttr(role + "_wait", name) || from->GetAttr("wait_strategy", name)))
+		return WaitStrategy();
+
+	return WaitStrategy(WaitStrategy::get_strategy(name),
+		from->FindAttr("wait_spins", static_cast<unsigned>(WaitStrategy::default_spins)),
+		from->FindAttr("wait_park_us", static_cast<unsigned>(WaitStrategy::default_park_us)));
+}
+
+//-------------------------------------------------------------------------------------------------
+ThreadPolicy Configuration::get_thread_policy(const XmlElement *from, const string& role, const ThreadPolicy& def) const
+{
+	ThreadPolicy policy(def);
+	if (!from)
+		return policy;
+
+	const string prefix(role.empty() ? role : role + '_');
+	string value;
+	if ((from->GetAttr(prefix + "cpus", value) || from->GetAttr("cpus", value)) && !policy.set_cpus(value))
+		throw InvalidConfiguration(prefix + "cpus=" + value);
+	if (from->GetAttr(prefix + "sched", value) || from->GetAttr("sched", value))
+	{
+		const int priority(from->FindAttr(prefix + "priority", from->FindAttr("priority", 0)));
+		if (!policy.set_sched(value, priority))
+			throw InvalidConfiguration(prefix + "sched=" + value);
+	}
+	policy.set_numa_node(from->FindAttr(prefix + "numa_node", from->FindAttr("numa_node", policy.get_numa_node())));
+
+	return policy;
+}
+
 //-------------------------------------------------------------------------------------------------
 string& Configuration::get_logname(const XmlElement *from, string& to, const SessionID *sid) const
 {
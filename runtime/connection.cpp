@@ -56,45 +56,65 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 using namespace FIX8;
 using namespace std;
 
+//-------------------------------------------------------------------------------------------------
+void FIXReader::dispatch()
+{
+	f8String msg;
+
+	for (bool first(true); frame(msg); first = false)	// every complete message received
+	{
+		if (first)
+			_session.update_received();
+		if (_pipelined)
+		{
+			if (!_msg_queue.try_push (msg))
+			{
+				_session.log("FIXReader: message queue is full");
+				++_dropped;
+			}
+			else
+			{
+				_wait.notify();
+				++_processed;
+			}
+		}
+		else
+		{
+			if (!_session.process(msg))
+			{
+				ostringstream ostr;
+				ostr << "Unhandled message: " << msg;
+				_session.log(ostr.str());
+				++_invalid;
+			}
+			else
+				++_processed;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void FIXReader::report(const int retval)
+{
+	ostringstream ostr;
+	ostr << "FIXReader: " << _processed << " messages processed, " << _dropped << " dropped, "
+		<< _invalid << " invalid";
+	if (retval)
+		ostr << " (socket error=" << errno << ')';
+	_session.log(ostr.str());
+}
+
 //-------------------------------------------------------------------------------------------------
 int FIXReader::operator()()
 {
-   unsigned processed(0), dropped(0), invalid(0);
 	int retval(0);
 
    for (; !_session.is_shutdown();)
    {
 		try
 		{
-			f8String msg;
-
-			if (read(msg))	// will block
-			{
-				if (_pipelined)
-				{
-					if (!_msg_queue.try_push (msg))
-					{
-						_session.log("FIXReader: message queue is full");
-						++dropped;
-					}
-					else
-						++processed;
-				}
-				else
-				{
-					if (!_session.process(msg))
-					{
-						ostringstream ostr;
-						ostr << "Unhandled message: " << msg;
-						_session.log(ostr.str());
-						++invalid;
-					}
-					else
-						++processed;
-				}
-			}
-			else
-				++invalid;
+			fill();	// will block
+			dispatch();
 		}
 		catch (Poco::Net::NetException& e)
 		{
@@ -111,20 +131,75 @@ int FIXReader::operator()()
 		catch (exception& e)	// also catches Poco::Net::NetException
 		{
 			_session.log(e.what());
-			++invalid;
+			++_invalid;
 		}
    }
 
-	ostringstream ostr;
-	ostr << "FIXReader: " << processed << " messages processed, " << dropped << " dropped, "
-		<< invalid << " invalid";
-	if (retval)
-		ostr << " (socket error=" << errno << ')';
-	_session.log(ostr.str());
-
+	report(retval);
 	return retval;
 }
 
+//-------------------------------------------------------------------------------------------------
+bool FIXReader::attach(Reactor *reactor)
+{
+	_socket_error = false;
+	if (_pipelined && _callback_thread.start())
+		_socket_error = true;
+	else if (reactor->add(_sock->impl()->sockfd(), this))
+	{
+		_reactor = reactor;
+		return true;
+	}
+	else
+		_socket_error = true;
+	_session.log("FIXReader: could not register with reactor");
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FIXReader::detach()
+{
+	if (!_reactor)
+		return;
+	_reactor->remove(this);
+	_reactor = 0;
+	report(_socket_error ? -1 : 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+bool FIXReader::on_readable()
+{
+	try
+	{
+		fill();	// won't block, socket is readable
+		dispatch();
+		return !_session.is_shutdown();
+	}
+	catch (Poco::Net::NetException& e)
+	{
+		_session.log(e.what());
+	}
+	catch (PeerResetConnection& e)
+	{
+		_session.log(e.what());
+	}
+	catch (exception& e)
+	{
+		_session.log(e.what());
+		++_invalid;
+		return true;
+	}
+
+	_socket_error = true;
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FIXReader::on_tick()
+{
+	_session.service_timer();
+}
+
 //-------------------------------------------------------------------------------------------------
 int FIXReader::callback_processor()
 {
@@ -135,21 +210,16 @@ int FIXReader::callback_processor()
 		f8String *msg_ptr(0);
 #if (MPMC_SYSTEM == MPMC_TBB)
       f8String msg;
-		_msg_queue.pop (msg); // will block
+		if (!_wait.pop(_msg_queue, msg))
+			continue;
       if (msg.empty())  // means exit
 			break;
 		msg_ptr = &msg;
 #else
-		if (_msg_queue.try_pop (msg_ptr)) // will not block
-		{
-			if (msg_ptr->empty())  // means exit
-				break;
-		}
-		else
-		{
-			hypersleep<h_nanoseconds>(250);
+		if (!_wait.pop(_msg_queue, msg_ptr))
 			continue;
-		}
+		if (msg_ptr->empty())  // means exit
+			break;
 #endif
 
       if (!_session.process(*msg_ptr))
@@ -180,65 +250,80 @@ void FIXReader::set_preamble_sz()
 }
 
 //-------------------------------------------------------------------------------------------------
-bool FIXReader::read(f8String& to)	// read a complete FIX message
+size_t FIXReader::fill()
 {
-	char msg_buf[_max_msg_len] = {};
-	int result(sockRead(msg_buf, _bg_sz));
+	if (_rhead == _rtail)
+		_rhead = _rtail = 0;
+	else if (_rbuf_sz - _rtail < _max_msg_len)	// move the partial message down to make room for the rest of it
+	{
+		::memmove(_rbuf, _rbuf + _rhead, _rtail - _rhead);
+		_rtail -= _rhead;
+		_rhead = 0;
+	}
 
-	if (result == static_cast<int>(_bg_sz))
+	for (;;)
 	{
-		char bt;
-		size_t offs(_bg_sz);
-		do	// get the last chrs of bodylength and ^A
+		const int rdSz(_sock->receiveBytes(_rbuf + _rtail, _rbuf_sz - _rtail));
+		if (rdSz > 0)
 		{
-			if (sockRead(&bt, 1) != 1)
-				return false;
-			if (!isdigit(bt) && bt != default_field_separator)
-				throw IllegalMessage(msg_buf);
-			msg_buf[offs++] = bt;
+			_rtail += rdSz;
+			return rdSz;
 		}
-		while (bt != default_field_separator && offs < _max_msg_len);
-		to.assign(msg_buf, offs);
-
-		f8String tag, bgstr, len;
-		unsigned result;
-		if ((result = MessageBase::extract_element(to.data(), to.size(), tag, bgstr)))
-		{
-			if (tag != "8")
-				throw IllegalMessage(to);
+		if (rdSz == 0)	// orderly shutdown by the peer
+			throw PeerResetConnection("connection gone");
+		if (errno == EINTR || (errno == EAGAIN && !_reactor))
+			continue;
+		if (errno != EAGAIN)
+			throw PeerResetConnection("connection gone");
+		return 0;	// spurious readiness; the reactor will report the socket again
+	}
+}
 
-			if (bgstr != _session.get_ctx()._beginStr)	// invalid FIX version
-				throw InvalidVersion(bgstr);
+//-------------------------------------------------------------------------------------------------
+bool FIXReader::frame(f8String& to)	// split a complete FIX message from the receive buffer
+{
+	const char *from(_rbuf + _rhead);
+	const size_t avail(_rtail - _rhead);
+	if (avail < _bg_sz)
+		return false;
 
-			if ((result = MessageBase::extract_element(to.data() + result, to.size() - result, tag, len)))
-			{
-				if (tag != "9")
-					throw IllegalMessage(to);
-
-				const unsigned mlen(fast_atoi<unsigned>(len.c_str()));
-				if (mlen == 0 || mlen > _max_msg_len - _bg_sz - _chksum_sz) // invalid msglen
-					throw InvalidBodyLength(mlen);
-
-				// read the body
-				if ((result = sockRead(msg_buf, mlen) != static_cast<int>(mlen)))
-					return false;
-
-				// read the checksum
-				if ((result = sockRead(msg_buf + mlen, _chksum_sz) != static_cast<int>(_chksum_sz)))
-					return false;
-
-				to.append(msg_buf, mlen + _chksum_sz);
-				_session.update_received();
-				//string ts;
-				//cerr << GetTimeAsStringMS(ts, &_session.get_last_received(), 9) << endl;
-				return true;
-			}
+	try
+	{
+		const f8String& bgstr(_session.get_ctx()._beginStr);
+		if (from[0] != '8' || from[1] != '=')
+			throw IllegalMessage(f8String(from, _bg_sz));
+		if (bgstr.compare(0, bgstr.size(), from + 2, bgstr.size()) || from[2 + bgstr.size()] != default_field_separator)
+			throw InvalidVersion(f8String(from + 2, bgstr.size()));	// invalid FIX version
+		if (from[_bg_sz - 3] != '9' || from[_bg_sz - 2] != '=')
+			throw IllegalMessage(f8String(from, _bg_sz));
+
+		size_t offs(_bg_sz - 1);
+		unsigned mlen(0);
+		for (; offs < avail && isdigit(from[offs]); ++offs)
+		{
+			if (offs + 1 - _bg_sz > 8)	// more digits than any valid length
+				throw IllegalMessage(f8String(from, offs));
+			mlen = (mlen << 3) + (mlen << 1) + from[offs] - '0';
 		}
-
-		throw IllegalMessage(to);
+		if (offs == avail)	// rest of bodylength not here yet
+			return false;
+		if (from[offs] != default_field_separator || offs == _bg_sz - 1)
+			throw IllegalMessage(f8String(from, offs + 1));
+		if (mlen == 0 || mlen > _max_msg_len - _bg_sz - _chksum_sz) // invalid msglen
+			throw InvalidBodyLength(mlen);
+
+		const size_t len(offs + 1 + mlen + _chksum_sz);
+		if (avail < len)	// partial message, carried over
+			return false;
+		to.assign(from, len);
+		_rhead += len;
+		return true;
+	}
+	catch (...)
+	{
+		_rhead = _rtail = 0;	// cannot resynchronise within the stream; discard what we have
+		throw;
 	}
-
-	return false;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -251,23 +336,20 @@ int FIXWriter::operator()()
 		try
 		{
 			Message *inmsg(0);
-#if (MPMC_SYSTEM == MPMC_TBB)
-			_msg_queue.pop (inmsg); // will block
-			if (!inmsg)
-				break;
-#else
-			if (_msg_queue.try_pop (inmsg)) // will not block
+			if (_batched)
 			{
-				if (!inmsg)  // means exit
-					break;
+				if (!_msg_queue.try_pop (inmsg)) // queue drained, send what we have
+				{
+					flush();
+					continue;
+				}
 			}
-			else
-			{
-				hypersleep<h_nanoseconds>(250);
+			else if (!_wait.pop(_msg_queue, inmsg))
 				continue;
-			}
-#endif
+			if (!inmsg)  // means exit
+				break;
 
+			_batching = _batch_frames > 1;	// send() will append to the batch
 #if defined MSGRECYCLING
 			_session.send_process(inmsg);
 			inmsg->set_in_use(false);
@@ -275,7 +357,10 @@ int FIXWriter::operator()()
 			scoped_ptr<Message> msg(inmsg);
 			_session.send_process(msg.get());
 #endif
+			_batching = false;
 			++processed;
+			if (batch_full())
+				flush();
 		}
 		catch (PeerResetConnection& e)
 		{
@@ -291,19 +376,110 @@ int FIXWriter::operator()()
 		}
 	}
 
+	_batching = false;
+	if (!result)
+	{
+		try
+		{
+			flush();	// anything batched before the exit request
+		}
+		catch (exception& e)
+		{
+			_session.log(e.what());
+			result = -1;
+		}
+	}
+
 	ostringstream ostr;
-	ostr << "FIXWriter: " << processed << " messages processed, " << invalid << " invalid";
+	ostr << "FIXWriter: " << processed << " messages processed, " << invalid << " invalid, "
+		<< _writes << " batched writes (" << _frames_written << " frames, max " << _max_frames_written << " per write)";
 	_session.log(ostr.str());
 
 	return result;
 }
 
+//-------------------------------------------------------------------------------------------------
+int FIXWriter::batch(const char *from, const size_t sz)
+{
+	if (_batched == _max_batch || _wtail + sz > _wbuf_sz)
+		flush();
+	if (sz > _wbuf_sz)	// will never fit; send it on its own
+	{
+		_batching = false;
+		const int result(send(from, sz));
+		_batching = true;
+		return result;
+	}
+
+	if (!_batched)
+		_batch_start.now();
+	::memcpy(_wbuf + _wtail, from, sz);
+	_iov[_batched].iov_base = _wbuf + _wtail;
+	_iov[_batched].iov_len = sz;
+	_wtail += sz;
+	++_batched;
+	return sz;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t FIXWriter::flush()
+{
+	if (!_batched)
+		return 0;
+
+	msghdr mh = {};
+	mh.msg_iov = _iov;
+	mh.msg_iovlen = _batched;
+	size_t wrdone(0);
+
+	while (mh.msg_iovlen)
+	{
+		const ssize_t wrtSz(::sendmsg(_sock->impl()->sockfd(), &mh, MSG_NOSIGNAL));
+		if (wrtSz < 0)
+		{
+			if (errno == EAGAIN || errno == EINTR)
+				continue;
+			_batched = 0;
+			_wtail = 0;
+			throw PeerResetConnection("connection gone");
+		}
+
+		wrdone += wrtSz;
+		for (size_t left(wrtSz); left; )	// skip what was sent, trimming a partially sent frame
+		{
+			if (left >= mh.msg_iov->iov_len)
+			{
+				left -= mh.msg_iov->iov_len;
+				++mh.msg_iov;
+				--mh.msg_iovlen;
+			}
+			else
+			{
+				mh.msg_iov->iov_base = static_cast<char *>(mh.msg_iov->iov_base) + left;
+				mh.msg_iov->iov_len -= left;
+				left = 0;
+			}
+		}
+	}
+
+	++_writes;
+	_frames_written += _batched;
+	if (_batched > _max_frames_written)
+		_max_frames_written = _batched;
+	_batched = 0;
+	_wtail = 0;
+	return wrdone;
+}
+
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 void Connection::start()
 {
 	_writer.start();
-	_reader.start();
+	if (_reactor)
+		_reader.attach(_reactor);
+	else
+		_reader.start();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -313,10 +489,25 @@ void Connection::stop()
 	_writer.stop();
 	_writer.join();
 	_reader.stop();
-	_reader.join();
+	if (_reactor)
+		_reader.detach();
+	else
+		_reader.join();
 	_reader.socket()->shutdownReceive();
 }
 
+//-------------------------------------------------------------------------------------------------
+int Connection::join()
+{
+	if (!_reactor)
+		return _reader.join();
+	if (Reactor::is_reactor_thread())	// waiting here would stall the reactor servicing this session
+		return -1;
+	while (!_session.is_shutdown() && !_reader.is_socket_error())
+		hypersleep<h_milliseconds>(10);
+	return 0;
+}
+
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 bool ClientConnection::connect()
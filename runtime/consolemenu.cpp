@@ -357,7 +357,7 @@ void ConsoleMenu::EditMsg(tty_save_state& tty, const FieldTable::Pair *fld, Mess
 		}
 	}
 
-	BaseField *bf(fld->_value._create(txt, fld->_value._rlm, rval));
+	BaseField *bf(fld->_value._create(txt.data(), txt.size(), fld->_value._rlm, rval));
 	msg->add_field(bf->get_tag(), msg->get_fp().get_presence().end(), 0, bf, true);
 }
 
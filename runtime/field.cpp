@@ -54,7 +54,7 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 namespace FIX8 {
 
 //-------------------------------------------------------------------------------------------------
-BaseEntry *BaseEntry_ctor(BaseEntry *be, BaseField *(*create)(const f8String&, const RealmBase*, int rv),
+BaseEntry *BaseEntry_ctor(BaseEntry *be, BaseField *(*create)(const char *, const size_t, const RealmBase*, int rv),
 		const RealmBase *rlm, const char *name, const char *comment)
 {
 	be->_create = create;
@@ -64,5 +64,405 @@ BaseEntry *BaseEntry_ctor(BaseEntry *be, BaseField *(*create)(const f8String&, c
 	return be;
 }
 
+//-------------------------------------------------------------------------------------------------
+namespace {
+	const Tickval::ticks _secs_per_day(86400ULL), _ticks_per_day(_secs_per_day * Tickval::billion);
+	const unsigned _frac_div[] = { 1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+
+	/// Per thread "YYYYMMDD-" prefix of the last formatted day.
+	struct DateCache
+	{
+		long _day;
+		char _str[9];
+	};
+	__thread DateCache _date_cache = { -1, {} };
+
+	inline unsigned get_digits(const char *from, const int width)
+	{
+		unsigned result(0);
+		for (int ii(0); ii < width; ++ii)
+			result = (result << 3) + (result << 1) + (from[ii] - '0');
+		return result;
+	}
+
+	inline bool is_digits(const char *from, const int width)
+	{
+		for (int ii(0); ii < width; ++ii)
+			if (from[ii] < '0' || from[ii] > '9')
+				return false;
+		return true;
+	}
+
+	inline void put_digits(unsigned val, char *to, int width)
+	{
+		while (width-- > 0)
+		{
+			to[width] = val % 10 + '0';
+			val /= 10;
+		}
+	}
+
+	/// Days since the epoch of a civil date (proleptic Gregorian).
+	inline long days_from_civil(int year, const unsigned month, const unsigned day)
+	{
+		year -= month <= 2;
+		const long era((year >= 0 ? year : year - 399) / 400);
+		const unsigned yoe(year - era * 400), doy((153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1),
+			doe(yoe * 365 + yoe / 4 - yoe / 100 + doy);
+		return era * 146097 + doe - 719468;
+	}
+
+	/// Civil date of a number of days since the epoch.
+	inline void civil_from_days(long days, unsigned& year, unsigned& month, unsigned& day)
+	{
+		days += 719468;
+		const long era((days >= 0 ? days : days - 146096) / 146097);
+		const unsigned doe(days - era * 146097), yoe((doe - doe / 1460 + doe / 36524 - doe / 146096) / 365),
+			doy(doe - (365 * yoe + yoe / 4 - yoe / 100)), mp((5 * doy + 2) / 153);
+		day = doy - (153 * mp + 2) / 5 + 1;
+		month = mp < 10 ? mp + 3 : mp - 9;
+		year = yoe + era * 400 + (month <= 2);
+	}
+
+	/// Parse a "YYYYMMDD" date; returns false if it is not a valid calendar date.
+	inline bool parse_date(const char *from, long& days)
+	{
+		static const unsigned mdays[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		if (!is_digits(from, 8))
+			return false;
+		const unsigned year(get_digits(from, 4)), month(get_digits(from + 4, 2)), mday(get_digits(from + 6, 2));
+		if (month < 1 || month > 12 || mday < 1 || mday > mdays[month - 1]
+			|| (month == 2 && mday == 29 && (year % 4 || (year % 100 == 0 && year % 400))))
+				return false;
+		days = days_from_civil(year, month, mday);
+		return true;
+	}
+
+	/// Parse "HH:MM" and, if with_secs, ":SS"; returns false if malformed or out of range (a leap second is allowed).
+	inline bool parse_hms(const char *from, const bool with_secs, unsigned& sod)
+	{
+		if (!is_digits(from, 2) || from[2] != ':' || !is_digits(from + 3, 2)
+			|| (with_secs && (from[5] != ':' || !is_digits(from + 6, 2))))
+				return false;
+		const unsigned hh(get_digits(from, 2)), mm(get_digits(from + 3, 2)), ss(with_secs ? get_digits(from + 6, 2) : 0);
+		if (hh > 23 || mm > 59 || ss > 60)
+			return false;
+		sod = hh * 3600 + mm * 60 + ss;
+		return true;
+	}
+
+	/// Parse an optional ".fff" fraction; returns nanoseconds and sets the precision. A '.' with no digits
+	/// is left unconsumed so the caller sees it as trailing garbage.
+	inline Tickval::ticks parse_fraction(const char *&from, const char *eptr, TimePrecision *prec)
+	{
+		int digits(0);
+		unsigned frac(0);
+		if (from + 1 < eptr && *from == '.' && from[1] >= '0' && from[1] <= '9')
+		{
+			for (++from; from < eptr && *from >= '0' && *from <= '9'; ++from)
+			{
+				if (digits < tp_nanoseconds)
+				{
+					frac = (frac << 3) + (frac << 1) + (*from - '0');
+					++digits;
+				}
+			}
+		}
+		if (prec)
+			*prec = digits == 0 ? tp_seconds : digits <= 3 ? tp_milliseconds : digits <= 6 ? tp_microseconds : tp_nanoseconds;
+		return static_cast<Tickval::ticks>(frac) * _frac_div[digits];
+	}
+
+	/// Write "HH:MM:SS[.fff]" for a second of day and nanosecond remainder.
+	inline size_t put_time(const unsigned sod, const unsigned nsecs, char *to, const TimePrecision prec)
+	{
+		put_digits(sod / 3600, to, 2);
+		to[2] = ':';
+		put_digits(sod / 60 % 60, to + 3, 2);
+		to[5] = ':';
+		put_digits(sod % 60, to + 6, 2);
+		if (prec == tp_seconds)
+			return 8;
+		to[8] = '.';
+		put_digits(nsecs / _frac_div[prec], to + 9, prec);
+		return 9 + prec;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+Tickval::ticks date_time_parse(const char *from, const size_t len, TimePrecision *prec)
+{
+	if (prec)
+		*prec = tp_seconds;
+	long days;
+	unsigned sod;
+	if (len < 17 || from[8] != '-' || !parse_date(from, days) || !parse_hms(from + 9, true, sod))	// YYYYMMDD-HH:MM:SS
+		return Tickval::noticks;
+	const char *eptr(from + len);
+	from += 17;
+	const Tickval::ticks frac(parse_fraction(from, eptr, prec));
+	if (from != eptr)
+	{
+		if (prec)
+			*prec = tp_seconds;
+		return Tickval::noticks;
+	}
+	return (days * _secs_per_day + sod) * Tickval::billion + frac;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t date_time_format(const Tickval::ticks tv, char *to, const TimePrecision prec)
+{
+	const long day(tv / _ticks_per_day);
+	if (day != _date_cache._day)
+	{
+		unsigned year, month, mday;
+		civil_from_days(day, year, month, mday);
+		put_digits(year, _date_cache._str, 4);
+		put_digits(month, _date_cache._str + 4, 2);
+		put_digits(mday, _date_cache._str + 6, 2);
+		_date_cache._str[8] = '-';
+		_date_cache._day = day;
+	}
+	::memcpy(to, _date_cache._str, sizeof(_date_cache._str));
+	const Tickval::ticks tod(tv % _ticks_per_day);
+	return sizeof(_date_cache._str) + put_time(tod / Tickval::billion, tod % Tickval::billion, to + sizeof(_date_cache._str), prec);
+}
+
+//-------------------------------------------------------------------------------------------------
+Tickval::ticks time_parse(const char *from, const size_t len, TimePrecision *prec, size_t *consumed)
+{
+	const char *bptr(from), *eptr(from + len);
+	Tickval::ticks result(Tickval::noticks);
+	unsigned sod;
+	if (prec)
+		*prec = tp_seconds;
+	if (len >= 5 && parse_hms(from, len >= 8 && from[5] == ':', sod))	// HH:MM[:SS]
+	{
+		from += len >= 8 && from[5] == ':' ? 8 : 5;
+		result = sod * Tickval::billion + parse_fraction(from, eptr, prec);
+		if (!consumed && from != eptr)	// only a caller parsing a suffix may leave characters over
+		{
+			if (prec)
+				*prec = tp_seconds;
+			result = Tickval::noticks;
+		}
+	}
+	else
+		from = bptr;
+	if (consumed)
+		*consumed = from - bptr;
+	return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t time_format(const Tickval::ticks tv, char *to, const TimePrecision prec)
+{
+	const Tickval::ticks tod(tv % _ticks_per_day);
+	return put_time(tod / Tickval::billion, tod % Tickval::billion, to, prec);
+}
+
+//-------------------------------------------------------------------------------------------------
+Tickval::ticks date_parse(const char *from, const size_t len)
+{
+	long days;
+	return len != 8 || !parse_date(from, days) ? Tickval::noticks : days * _ticks_per_day;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t date_format(const Tickval::ticks tv, char *to)
+{
+	unsigned year, month, mday;
+	civil_from_days(tv / _ticks_per_day, year, month, mday);
+	put_digits(year, to, 4);
+	put_digits(month, to + 4, 2);
+	put_digits(mday, to + 6, 2);
+	return 8;
+}
+
+//-------------------------------------------------------------------------------------------------
+int tz_parse(const char *from, const size_t len, bool *valid)
+{
+	if (len < 3 || (*from != '+' && *from != '-'))	// Z or nothing
+	{
+		if (valid)
+			*valid = !len || (len == 1 && *from == 'Z');
+		return 0;
+	}
+	const bool mins(len == 6 && from[3] == ':' && is_digits(from + 4, 2));
+	if (valid)
+		*valid = is_digits(from + 1, 2) && (len == 3 || mins) && get_digits(from + 1, 2) < 24 && (!mins || get_digits(from + 4, 2) < 60);
+	int result(get_digits(from + 1, 2) * 60);
+	if (mins)
+		result += get_digits(from + 4, 2);
+	return *from == '-' ? -result : result;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t tz_format(const int tzdiff, char *to)
+{
+	if (!tzdiff)
+	{
+		*to = 'Z';
+		return 1;
+	}
+	const unsigned mins(tzdiff < 0 ? -tzdiff : tzdiff);
+	to[0] = tzdiff < 0 ? '-' : '+';
+	put_digits(mins / 60, to + 1, 2);
+	to[3] = ':';
+	put_digits(mins % 60, to + 4, 2);
+	return 6;
+}
+
+//-------------------------------------------------------------------------------------------------
+namespace {
+	/// Open addressed table of interned values keyed by hash, so a lookup compares (pointer, length) in place
+	/// and only a new value is copied.
+	struct InternTable
+	{
+		enum { slots = StringIntern::max_entries * 2 };	// power of two; at most half full
+		f8_mutex _mutex;
+		unsigned _count;
+		const f8String *_values[slots];
+
+		InternTable() : _count() { std::fill(_values, _values + slots, static_cast<const f8String *>(0)); }
+	};
+
+	InternTable& intern_table()
+	{
+		static InternTable *table(new InternTable);	// never destroyed; interned values outlive static dtors
+		return *table;
+	}
+
+	__thread const f8String *_intern_cache[StringIntern::cache_size];
+}
+
+//-------------------------------------------------------------------------------------------------
+const f8String *StringIntern::intern(const char *from, const size_t len)
+{
+	if (len > max_length)
+		return 0;
+
+	unsigned hv(len);
+	for (size_t ii(0); ii < len; ++ii)
+		hv = hv * 31 + static_cast<unsigned char>(from[ii]);
+
+	const f8String *& slot(_intern_cache[hv & (cache_size - 1)]);
+	if (slot && slot->size() == len && ::memcmp(slot->data(), from, len) == 0)
+		return slot;
+
+	InternTable& table(intern_table());
+	f8_scoped_lock guard(table._mutex);
+	unsigned idx(hv & (InternTable::slots - 1));
+	for (const f8String *val; (val = table._values[idx]); idx = (idx + 1) & (InternTable::slots - 1))
+		if (val->size() == len && ::memcmp(val->data(), from, len) == 0)
+			return slot = val;
+	if (table._count >= max_entries)
+		return 0;
+	++table._count;
+	return slot = table._values[idx] = new f8String(from, len);
+}
+
+#if defined FIELDPOOLING
+//-------------------------------------------------------------------------------------------------
+namespace {
+	__thread FieldPool *_thread_pool;
+	pthread_key_t _pool_key;
+	pthread_once_t _pool_once = PTHREAD_ONCE_INIT;
+	f8_mutex _orphan_mutex;
+	std::vector<FieldPool *> _orphans;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FieldPool::make_key()
+{
+	pthread_key_create(&_pool_key, thread_exit);
+}
+
+//-------------------------------------------------------------------------------------------------
+void FieldPool::thread_exit(void *pool)
+{
+	f8_scoped_lock guard(_orphan_mutex);
+	_orphans.push_back(static_cast<FieldPool *>(pool));
+	_thread_pool = 0;	// the pool may now be adopted by another thread; anything freed after this readopts one
+}
+
+//-------------------------------------------------------------------------------------------------
+FieldPool *FieldPool::instance()
+{
+	if (_thread_pool)
+		return _thread_pool;
+
+	pthread_once(&_pool_once, make_key);
+	{
+		f8_scoped_lock guard(_orphan_mutex);
+		if (_orphans.empty())
+			_thread_pool = new FieldPool;
+		else
+		{
+			_thread_pool = _orphans.back();
+			_orphans.pop_back();
+		}
+	}
+	pthread_setspecific(_pool_key, _thread_pool);
+	return _thread_pool;
+}
+
+//-------------------------------------------------------------------------------------------------
+void *FieldPool::allocate(const unsigned sclass)
+{
+	Block *blk(_free[sclass]);
+	if (blk)
+	{
+		_free[sclass] = blk->_next;
+		return blk;
+	}
+
+	if (_remote_cnt[sclass])	// reclaim blocks released by other threads
+	{
+		f8_scoped_lock guard(_remote_mutex);
+		if ((blk = _remote[sclass]))
+		{
+			_remote[sclass] = 0;
+			_remote_cnt[sclass] = 0;
+			_free[sclass] = blk->_next;
+			return blk;
+		}
+	}
+
+	const size_t sz((sclass + 1) * granularity);
+	if (_cur + sz > _end)
+	{
+		void *slab;
+		if (posix_memalign(&slab, slab_size, slab_size))
+			throw std::bad_alloc();
+		*static_cast<FieldPool **>(slab) = this;
+		_cur = static_cast<char *>(slab) + slab_header;
+		_end = static_cast<char *>(slab) + slab_size;
+	}
+	void *where(_cur);
+	_cur += sz;
+	return where;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FieldPool::release(void *what, const unsigned sclass, bool remote)
+{
+	Block *blk(static_cast<Block *>(what));
+	if (remote)
+	{
+		f8_scoped_lock guard(_remote_mutex);
+		blk->_next = _remote[sclass];
+		_remote[sclass] = blk;
+		++_remote_cnt[sclass];
+	}
+	else
+	{
+		blk->_next = _free[sclass];
+		_free[sclass] = blk;
+	}
+}
+#endif
+
 } // namespace FIX8
 
@@ -259,7 +259,7 @@ bool FilePersister::put(const unsigned sender_seqnum, const unsigned target_seqn
 }
 
 //-------------------------------------------------------------------------------------------------
-bool FilePersister::put(const unsigned seqnum, const f8String& what)
+bool FilePersister::put(const unsigned seqnum, const char *what, const size_t sz)
 {
 	if (!_opened || !seqnum)
 		return false;
@@ -286,7 +286,7 @@ bool FilePersister::put(const unsigned seqnum, const f8String& what)
 		GlobalLogger::log(eostr.str());
 		return false;
 	}
-	IPrec iprec(seqnum, offset, what.size());
+	IPrec iprec(seqnum, offset, sz);
 	if (write (_iod, static_cast<void *>(&iprec), sizeof(IPrec)) != sizeof(IPrec))
 	{
 		ostringstream eostr;
@@ -294,7 +294,7 @@ bool FilePersister::put(const unsigned seqnum, const f8String& what)
 		GlobalLogger::log(eostr.str());
 		return false;
 	}
-	if (write (_fod, what.data(), what.size()) != static_cast<ssize_t>(what.size()))
+	if (write (_fod, what, sz) != static_cast<ssize_t>(sz))
 	{
 		ostringstream eostr;
 		eostr << "Error could not write record for seqnum " << seqnum << " to: " << _dbFname;
@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+//-----------------------------------------------------------------------------------------
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <iterator>
+#include <algorithm>
+#include <bitset>
+
+#include <strings.h>
+#include <regex.h>
+
+#include <f8includes.hpp>
+
+//-------------------------------------------------------------------------------------------------
+using namespace FIX8;
+
+//-------------------------------------------------------------------------------------------------
+/// Recycled frame buffers. Frames released once the pool has been drained at exit are deleted.
+class OutboundFrame::Pool
+{
+	f8_mutex _mutex;
+	std::vector<Rep *> _reps;
+	bool _closed;
+
+public:
+	Pool() : _closed() {}
+
+	/// Dtor. Frees the pooled buffers.
+	~Pool()
+	{
+		f8_scoped_lock guard(_mutex);
+		_closed = true;
+		for (std::vector<Rep *>::iterator itr(_reps.begin()); itr != _reps.end(); ++itr)
+			delete *itr;
+		_reps.clear();
+	}
+
+	/*! Take a buffer from the pool.
+	    \return buffer or 0 if the pool is empty */
+	Rep *get()
+	{
+		f8_scoped_lock guard(_mutex);
+		if (_closed || _reps.empty())
+			return 0;
+		Rep *rep(_reps.back());
+		_reps.pop_back();
+		return rep;
+	}
+
+	/*! Return a buffer to the pool.
+	    \param rep buffer to return
+	    \return true if pooled, false if the caller should delete it */
+	bool put(Rep *rep)
+	{
+		f8_scoped_lock guard(_mutex);
+		if (_closed || _reps.size() >= pool_max)
+			return false;
+		_reps.push_back(rep);
+		return true;
+	}
+};
+
+OutboundFrame::Pool OutboundFrame::_pool;
+
+//-------------------------------------------------------------------------------------------------
+OutboundFrame::Rep *OutboundFrame::acquire()
+{
+	Rep *rep(_pool.get());
+	if (!rep)
+		rep = new Rep;
+	rep->_refs = 1;
+	rep->_frame = rep->_buffer;
+	rep->_len = 0;
+	return rep;
+}
+
+//-------------------------------------------------------------------------------------------------
+void OutboundFrame::release(Rep *rep)
+{
+	if (--rep->_refs > 0)
+		return;
+	if (!_pool.put(rep))
+		delete rep;
+}
+
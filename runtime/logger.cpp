@@ -80,11 +80,8 @@ int Logger::operator()()
 		LogElement *msg_ptr(0);
 
 #if (MPMC_SYSTEM == MPMC_FF)
-		if (!_msg_queue.try_pop(msg_ptr))
-		{
-			hypersleep<h_milliseconds>(1);
+		if (!_wait.pop(_msg_queue, msg_ptr))
 			continue;
-		}
 #else
 		LogElement msg;
 		if (_stopping)	// make sure we dequeue any pending msgs before exiting
@@ -92,8 +89,8 @@ int Logger::operator()()
 			if (!_msg_queue.try_pop(msg))
 				break;
 		}
-		else
-			_msg_queue.pop (msg); // will block
+		else if (!_wait.pop(_msg_queue, msg))
+			continue;
 		msg_ptr = &msg;
 #endif
 
@@ -102,7 +99,7 @@ int Logger::operator()()
 
 		if (msg_ptr)
 		{
-			if (msg_ptr->_str.empty())  // means exit
+			if (msg_ptr->_str.empty() && msg_ptr->_frame.empty())  // means exit
 			{
 #if (MPMC_SYSTEM == MPMC_FF)
 				break;
@@ -137,13 +134,21 @@ int Logger::operator()()
 			if (_flags & buffer)
 			{
 				string result(ostr.str());
-				result += msg_ptr->_str;
+				if (msg_ptr->_frame.empty())
+					result += msg_ptr->_str;
+				else
+					result.append(msg_ptr->_frame.data(), msg_ptr->_frame.size());
 				_buffer.push_back(result);
 			}
 			else
 			{
 				f8_scoped_lock guard(_mutex);
-				get_stream() << ostr.str() << msg_ptr->_str << endl;
+				get_stream() << ostr.str();
+				if (msg_ptr->_frame.empty())
+					get_stream() << msg_ptr->_str;
+				else
+					get_stream().write(msg_ptr->_frame.data(), msg_ptr->_frame.size());
+				get_stream() << endl;
 			}
 		}
 #if (MPMC_SYSTEM == MPMC_FF)
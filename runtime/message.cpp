@@ -52,6 +52,11 @@ HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include <f8includes.hpp>
 
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define F8_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
 //-------------------------------------------------------------------------------------------------
 using namespace FIX8;
 using namespace std;
@@ -61,34 +66,144 @@ using namespace std;
 codec_timings Message::_encode_timings, Message::_decode_timings;
 #endif
 
+//-------------------------------------------------------------------------------------------------
+// checksum kernels; byte sums are returned unreduced, callers take % 256
+namespace {
+	unsigned sum_bytes_scalar(const char *from, const size_t sz)
+	{
+		unsigned val(0);
+		for (const char *eptr(from + sz); from < eptr; val += static_cast<unsigned char>(*from++));
+		return val;
+	}
+
+	unsigned copy_sum_bytes_scalar(char *to, const char *from, const size_t sz)
+	{
+		unsigned val(0);
+		for (const char *eptr(from + sz); from < eptr; val += static_cast<unsigned char>(*to++ = *from++));
+		return val;
+	}
+
+#if defined __SSE2__
+	// _mm_sad_epu8 against zero sums each 8 byte half into a 64 bit lane
+	unsigned sum_bytes_sse2(const char *from, const size_t sz)
+	{
+		const __m128i zero(_mm_setzero_si128());
+		__m128i acc(zero);
+		const char *eptr(from + sz);
+		for (; from + 16 <= eptr; from += 16)
+			acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(from)), zero));
+		return static_cast<unsigned>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)))
+			+ sum_bytes_scalar(from, eptr - from);
+	}
+
+	unsigned copy_sum_bytes_sse2(char *to, const char *from, const size_t sz)
+	{
+		const __m128i zero(_mm_setzero_si128());
+		__m128i acc(zero);
+		const char *eptr(from + sz);
+		for (; from + 16 <= eptr; from += 16, to += 16)
+		{
+			const __m128i blk(_mm_loadu_si128(reinterpret_cast<const __m128i *>(from)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(to), blk);
+			acc = _mm_add_epi64(acc, _mm_sad_epu8(blk, zero));
+		}
+		return static_cast<unsigned>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)))
+			+ copy_sum_bytes_scalar(to, from, eptr - from);
+	}
+#endif
+
+#if defined F8_AVX2_DISPATCH
+	__attribute__((target("avx2"))) unsigned sum_bytes_avx2(const char *from, const size_t sz)
+	{
+		const __m256i zero(_mm256_setzero_si256());
+		__m256i acc(zero);
+		const char *eptr(from + sz);
+		for (; from + 32 <= eptr; from += 32)
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(from)), zero));
+		const __m128i acc2(_mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+		return static_cast<unsigned>(_mm_cvtsi128_si32(acc2) + _mm_cvtsi128_si32(_mm_srli_si128(acc2, 8)))
+			+ sum_bytes_scalar(from, eptr - from);
+	}
+
+	__attribute__((target("avx2"))) unsigned copy_sum_bytes_avx2(char *to, const char *from, const size_t sz)
+	{
+		const __m256i zero(_mm256_setzero_si256());
+		__m256i acc(zero);
+		const char *eptr(from + sz);
+		for (; from + 32 <= eptr; from += 32, to += 32)
+		{
+			const __m256i blk(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(from)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(to), blk);
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(blk, zero));
+		}
+		const __m128i acc2(_mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+		return static_cast<unsigned>(_mm_cvtsi128_si32(acc2) + _mm_cvtsi128_si32(_mm_srli_si128(acc2, 8)))
+			+ copy_sum_bytes_scalar(to, from, eptr - from);
+	}
+
+	bool have_avx2()
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	}
+#endif
+
+	unsigned (*select_sum_bytes())(const char *, const size_t)
+	{
+#if defined F8_AVX2_DISPATCH
+		if (have_avx2())
+			return sum_bytes_avx2;
+#endif
+#if defined __SSE2__
+		return sum_bytes_sse2;
+#else
+		return sum_bytes_scalar;
+#endif
+	}
+
+	unsigned (*select_copy_sum_bytes())(char *, const char *, const size_t)
+	{
+#if defined F8_AVX2_DISPATCH
+		if (have_avx2())
+			return copy_sum_bytes_avx2;
+#endif
+#if defined __SSE2__
+		return copy_sum_bytes_sse2;
+#else
+		return copy_sum_bytes_scalar;
+#endif
+	}
+}
+
+unsigned (*Message::_sum_bytes)(const char *, const size_t)(select_sum_bytes());
+unsigned (*Message::_copy_sum_bytes)(char *, const char *, const size_t)(select_copy_sum_bytes());
+
 //-------------------------------------------------------------------------------------------------
 namespace {
 	const string spacer(3, ' ');
 }
 
 //-------------------------------------------------------------------------------------------------
-unsigned MessageBase::extract_header(const f8String& from, f8String& len, f8String& mtype)
+unsigned MessageBase::extract_header(FieldIndex& idx, unsigned& len, f8String& mtype)
 {
-	const char *dptr(from.data());
-
-	char tag[MAX_FLD_LENGTH], val[MAX_FLD_LENGTH];
-	unsigned s_offset(0), result;
-	if ((result = extract_element(dptr, from.size(), tag, val)))
+	const char *val;
+	unsigned s_offset(0), result, tv, vlen;
+	if ((result = idx.extract(s_offset, tv, val, vlen)))
 	{
-		if (*tag != '8')
+		if (tv != Common_BeginString)
 			return 0;
 		s_offset += result;
-		if ((result = extract_element(dptr + s_offset, from.size() - s_offset, tag, val)))
+		if ((result = idx.extract(s_offset, tv, val, vlen)))
 		{
-			if (*tag != '9')
+			if (tv != Common_BodyLength)
 				return 0;
-			len = val;
+			len = fast_atoi<unsigned>(val, val + vlen);
 			s_offset += result;
-			if ((result = extract_element(dptr + s_offset, from.size() - s_offset, tag, val)))
+			if ((result = idx.extract(s_offset, tv, val, vlen)))
 			{
-				if (*tag != '3' || *(tag + 1) != '5')
+				if (tv != Common_MsgType)
 					return 0;
-				mtype = val;
+				mtype.assign(val, vlen);
 				s_offset += result;
 			}
 		}
@@ -104,17 +219,18 @@ unsigned MessageBase::extract_trailer(const f8String& from, f8String& chksum)
 }
 
 //-------------------------------------------------------------------------------------------------
-unsigned MessageBase::decode(const f8String& from, const unsigned offset)
+unsigned MessageBase::decode(const char *from, const unsigned sz, const unsigned offset, FieldIndex *idx)
 {
-	unsigned s_offset(offset), result;
-	const unsigned fsize(from.size());
-	const char *dptr(from.data());
-	char tag[MAX_FLD_LENGTH], val[MAX_FLD_LENGTH];
+	unsigned s_offset(offset), result, tv, vlen;
+	const char *val;
 
-	for (unsigned pos(_pos.size()); s_offset <= fsize && (result = extract_element(dptr + s_offset, fsize - s_offset, tag, val));)
+	if (!_rawbuf && !_interest && decode_specialised(from, sz, s_offset, idx))	// generated decoder, if any
+		return s_offset;
+
+	while (s_offset <= sz && (result = idx ? idx->extract(s_offset, tv, val, vlen)
+		: extract_element(from + s_offset, sz - s_offset, tv, val, vlen)))
 	{
-		const unsigned tv(fast_atoi<unsigned>(tag));
-		const BaseEntry *be(_ctx._be.find_ptr(tv));
+		const BaseEntry *be(_ctx.find_be(tv));
 #if defined PERMIT_CUSTOM_FIELDS
 		if (!be && (!_ctx._ube || (be = _ctx._ube->find_ptr(tv)) == 0))
 #else
@@ -125,19 +241,31 @@ unsigned MessageBase::decode(const f8String& from, const unsigned offset)
 		if (!_fp.has(tv, itr))
 			break;
 		s_offset += result;
+		if (_interest && !FieldInterest::wants(*_interest, tv) && !_fp.is_group(tv, itr))	// selective decode
+			continue;
 		if (_fp.get(tv, itr, FieldTrait::present))
 		{
 			if (!_fp.get(tv, itr, FieldTrait::automatic))
 				throw DuplicateField(tv);
 		}
+		else if (_rawbuf && !_fp.is_group(tv, itr))	// lazy decode; constructed on first access
+			add_raw(tv, itr, s_offset - result, result, vlen);
 		else
 		{
-			add_field(tv, itr, ++pos, be->_create(val, be->_rlm, -1), false);
+			add_field(tv, itr, 0, be->_create(val, vlen, be->_rlm, -1), false);
 			if (_fp.is_group(tv, itr))
-				s_offset = decode_group(tv, from, s_offset);
+				s_offset = decode_group(tv, from, sz, s_offset, idx);
 		}
 	}
 
+	if (!_interest)
+		check_missing();
+	return s_offset;
+}
+
+//-------------------------------------------------------------------------------------------------
+void MessageBase::check_missing() const
+{
 	const unsigned short missing(_fp.find_missing());
 	if (missing)
 	{
@@ -146,34 +274,54 @@ unsigned MessageBase::decode(const f8String& from, const unsigned offset)
 		ostr << tbe._name << " (" << missing << ')';
 		throw MissingMandatoryField(ostr.str());
 	}
+}
 
-	return s_offset;
+//-------------------------------------------------------------------------------------------------
+bool MessageBase::decoded_end(const unsigned tv, const unsigned long long seen, const unsigned long long mandatory) const
+{
+	if (tv)
+	{
+		if (_fp.has(tv))	// in this message but unknown to the generated decoder (custom field)
+			return false;
+#if defined PERMIT_CUSTOM_FIELDS
+		if (!_ctx.find_be(tv) && (!_ctx._ube || _ctx._ube->find_ptr(tv) == 0))
+#else
+		if (!_ctx.find_be(tv))
+#endif
+			throw InvalidField(tv);
+	}
+	if ((seen & mandatory) != mandatory)
+		check_missing();
+	return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-unsigned MessageBase::decode_group(const unsigned short fnum, const f8String& from, const unsigned offset)
+unsigned MessageBase::decode_group(const unsigned short fnum, const char *from, const unsigned sz, const unsigned offset, FieldIndex *idx)
 {
-	unsigned s_offset(offset), result;
+	unsigned s_offset(offset), result, tv, vlen;
+	const char *val;
 	GroupBase *grpbase(find_group(fnum));
 	if (!grpbase)
 		throw InvalidRepeatingGroup(fnum);
-	const unsigned fsize(from.size());
-	const char *dptr(from.data());
-	char tag[MAX_FLD_LENGTH], val[MAX_FLD_LENGTH];
 
-	for (bool ok(true); ok && s_offset < fsize; )
+	for (bool ok(true); ok && s_offset < sz; )
 	{
 		scoped_ptr<MessageBase> grp(grpbase->create_group());
+		grp->_rawbuf = _rawbuf;
+		grp->_interest = _interest;
 
-		for (unsigned pos(0); s_offset < fsize && (result = extract_element(dptr + s_offset, fsize - s_offset, tag, val));)
+		for (unsigned pos(0); s_offset < sz && (result = idx ? idx->extract(s_offset, tv, val, vlen)
+			: extract_element(from + s_offset, sz - s_offset, tv, val, vlen));)
 		{
-			const unsigned tv(fast_atoi<unsigned>(tag));
 			Presence::const_iterator itr(grp->_fp.get_presence().end());
 			if (grp->_fp.get(tv, itr, FieldTrait::present))	// already present; next group?
 				break;
-			if (pos == 0 && grp->_fp.getPos(tv, itr) != 1)	// first field in group is mandatory
+			const unsigned short fpos(grp->_fp.getPos(tv, itr));
+			if (pos == 0 && fpos != 1)	// first field in group is mandatory
 				throw MissingRepeatingGroupField(tv);
-			const BaseEntry *be(_ctx._be.find_ptr(tv));
+			if (pos && fpos == 1)	// first field starts each repeat (it may have been skipped); next group?
+				break;
+			const BaseEntry *be(_ctx.find_be(tv));
 			if (!be)
 				throw InvalidField(tv);
 			if (!grp->_fp.has(tv, itr))	// field not found in sub-group - end of repeats?
@@ -182,26 +330,112 @@ unsigned MessageBase::decode_group(const unsigned short fnum, const f8String& fr
 				break;
 			}
 			s_offset += result;
-			grp->add_field(tv, itr, ++pos, be->_create(val, be->_rlm, -1), false);
+			++pos;
+			if (_interest && !FieldInterest::wants(*_interest, tv) && !grp->_fp.is_group(tv, itr))	// selective decode
+				continue;
+			if (_rawbuf && !grp->_fp.is_group(tv, itr))
+			{
+				grp->add_raw(tv, itr, s_offset - result, result, vlen);
+				continue;
+			}
+			grp->add_field(tv, itr, pos, be->_create(val, vlen, be->_rlm, -1), false);
 			grp->_fp.set(tv, itr, FieldTrait::present);	// is present
 			if (grp->_fp.is_group(tv, itr)) // nested group
-				s_offset = grp->decode_group(tv, from, s_offset);
+				s_offset = grp->decode_group(tv, from, sz, s_offset, idx);
 		}
 
-		const unsigned short missing(grp->_fp.find_missing());
-		if (missing)
-		{
-			const BaseEntry& tbe(_ctx._be.find_ref(missing));
-			ostringstream ostr;
-			ostr << tbe._name << " (" << missing << ')';
-			throw MissingMandatoryField(ostr.str());
-		}
+		if (!_interest)
+			grp->check_missing();
 		*grpbase += grp.release();
 	}
 
 	return s_offset;
 }
 
+//-------------------------------------------------------------------------------------------------
+unsigned MessageBase::visit(const char *from, const unsigned sz, const unsigned offset, FieldIndex& idx, MessageVisitor& vis) const
+{
+	unsigned s_offset(offset), result, tv, vlen;
+	const char *val;
+
+	while (s_offset <= sz && (result = idx.extract(s_offset, tv, val, vlen)))
+	{
+		const BaseEntry *be(_ctx.find_be(tv));
+#if defined PERMIT_CUSTOM_FIELDS
+		if (!be && (!_ctx._ube || (be = _ctx._ube->find_ptr(tv)) == 0))
+#else
+		if (!be)
+#endif
+			throw InvalidField(tv);
+		Presence::const_iterator itr(_fp.get_presence().end());
+		if (!_fp.has(tv, itr))
+			break;
+		s_offset += result;
+		vis.on_field(tv, FieldValue(val, vlen, itr->_ftype, be));
+		if (itr->_field_traits.has(FieldTrait::group))
+			s_offset = visit_group(tv, fast_atoi<unsigned>(val, val + vlen), from, sz, s_offset, idx, vis);
+	}
+
+	return s_offset;
+}
+
+//-------------------------------------------------------------------------------------------------
+unsigned MessageBase::visit_group(const unsigned short fnum, const unsigned count, const char *from, const unsigned sz,
+	const unsigned offset, FieldIndex& idx, MessageVisitor& vis) const
+{
+	unsigned s_offset(offset), result, tv, vlen, inst(0);
+	const char *val;
+	const GroupBase *grpbase(find_group(fnum));
+	if (!grpbase)
+		throw InvalidRepeatingGroup(fnum);
+	const MessageBase *grp(grpbase->prototype());
+
+	vis.on_group_begin(fnum, count);
+	while (s_offset < sz && (result = idx.extract(s_offset, tv, val, vlen)))
+	{
+		Presence::const_iterator itr(grp->_fp.get_presence().end());
+		if (!grp->_fp.has(tv, itr))	// field not found in sub-group - end of repeats
+			break;
+		if (grp->_fp.getPos(tv, itr) == 1)	// first field in group starts each repeat
+			vis.on_group_instance(fnum, inst++);
+		else if (!inst)
+			throw MissingRepeatingGroupField(tv);
+		const BaseEntry *be(_ctx.find_be(tv));
+		if (!be)
+			throw InvalidField(tv);
+		s_offset += result;
+		vis.on_field(tv, FieldValue(val, vlen, itr->_ftype, be));
+		if (itr->_field_traits.has(FieldTrait::group)) // nested group
+			s_offset = grp->visit_group(tv, fast_atoi<unsigned>(val, val + vlen), from, sz, s_offset, idx, vis);
+	}
+	vis.on_group_end(fnum);
+
+	return s_offset;
+}
+
+//-------------------------------------------------------------------------------------------------
+void MessageBase::build_group_prototypes() const
+{
+	for (Groups::const_iterator itr(_groups.begin()); itr != _groups.end(); ++itr)
+		itr->second->prototype()->build_group_prototypes();
+}
+
+//-------------------------------------------------------------------------------------------------
+BaseField *MessageBase::materialise(const unsigned idx) const
+{
+	RawField& rf(_raw[idx]);
+	const BaseEntry *be(_ctx.find_be(rf._fnum));
+#if defined PERMIT_CUSTOM_FIELDS
+	if (!be && (!_ctx._ube || (be = _ctx._ube->find_ptr(rf._fnum)) == 0))
+#else
+	if (!be)
+#endif
+		throw InvalidField(rf._fnum);
+	const char *val(_rawbuf + rf._offset + rf._len - 1 - rf._vlen);
+	rf._len = 0;
+	return _fields[idx] = be->_create(val, rf._vlen, be->_rlm, -1);
+}
+
 //-------------------------------------------------------------------------------------------------
 unsigned MessageBase::check_positions()
 {
@@ -209,58 +443,180 @@ unsigned MessageBase::check_positions()
 }
 
 //-------------------------------------------------------------------------------------------------
-Message *Message::factory(const F8MetaCntx& ctx, const f8String& from)
+Message *Message::factory(const F8MetaCntx& ctx, const char *from, const size_t sz, const FieldInterest *interest)
 {
 	Message *msg(0);
-	f8String len, mtype;
-	if (extract_header(from, len, mtype))
+	unsigned mlen(0);
+	f8String mtype;
+	FieldIndex idx(from, sz);
+	if (extract_header(idx, mlen, mtype))
 	{
-		const unsigned mlen(fast_atoi<unsigned>(len.c_str()));
-		const BaseMsgEntry *bme(ctx._bme.find_ptr(mtype));
-		if (!bme)
+		const MsgTable::Pair *bmp(ctx.find_msg(mtype));
+		if (!bmp)
 			throw InvalidMessage(mtype);
-		msg = bme->_create();
+		if (!ctx._msg_pool_max || (msg = ctx.get_msg_pool(bmp).get()) == 0)
+		{
+			msg = bmp->_value._create();
 #if defined PERMIT_CUSTOM_FIELDS
-		if (ctx._ube)
-			ctx._ube->post_msg_ctor(msg);
+			if (ctx._ube)
+				ctx._ube->post_msg_ctor(msg);
 #endif
+		}
+		msg->_interest = interest ? interest->find(bmp) : 0;
 #if defined CODECTIMING
 		IntervalTimer itm;
 #endif
-		msg->decode(from);
+		try
+		{
+			msg->decode(from, sz, idx);
+		}
+		catch (...)
+		{
+			recycle(ctx, msg);
+			throw;
+		}
 #if defined CODECTIMING
 		_decode_timings._cpu_used += itm.Calculate().AsDouble();
 		++_decode_timings._msg_count;
 #endif
 
-		static_cast<body_length *>(msg->_header->_fields.find(Common_BodyLength)->second)->set(mlen);
-		Fields::const_iterator fitr(msg->_header->_fields.find(Common_MsgType));
-		static_cast<msg_type *>(fitr->second)->set(mtype);
+		static_cast<body_length *>(msg->_header->get_field(Common_BodyLength))->set(mlen);
+		BaseField *fld(msg->_header->get_field(Common_MsgType));
+		static_cast<msg_type *>(fld)->set(mtype);
 #if defined POPULATE_METADATA
-		msg->check_set_rlm(fitr->second);
+		msg->check_set_rlm(fld);
 #endif
 
-		const char *pp(from.data() + from.size() - 7);
-		if (*pp != '1' || *(pp + 1) != '0') // 10=XXX^A
-			throw InvalidMessage(from);
+		const char *pp(sz < 7 ? 0 : from + sz - 7);
+		if (!pp || *pp != '1' || *(pp + 1) != '0') // 10=XXX^A
+		{
+			recycle(ctx, msg);
+			throw InvalidMessage(f8String(from, sz));
+		}
 		if (!ctx.has_flag(F8MetaCntx::noverifychksum)) // permit chksum calculation to be skipped
 		{
 			const f8String chksum(pp + 3, 3);
-			static_cast<check_sum *>(msg->_trailer->_fields.find(Common_CheckSum)->second)->set(chksum);
-			const unsigned chkval(fast_atoi<unsigned>(chksum.c_str())), mchkval(calc_chksum(from, 0, from.size() - 7));
+			static_cast<check_sum *>(msg->_trailer->get_field(Common_CheckSum))->set(chksum);
+			const unsigned chkval(fast_atoi<unsigned>(pp + 3, pp + 6)), mchkval(calc_chksum(from, sz, 0, sz - 7));
 			if (chkval != mchkval)
+			{
+				recycle(ctx, msg);
 				throw BadCheckSum(mchkval);
+			}
 		}
 	}
 	else
 	{
 		//cerr << "Message::factory throwing" << endl;
-		throw InvalidMessage(from);
+		throw InvalidMessage(f8String(from, sz));
 	}
 
 	return msg;
 }
 
+//-------------------------------------------------------------------------------------------------
+unsigned Message::decode(const F8MetaCntx& ctx, const char *from, const size_t sz, MessageVisitor& vis)
+{
+	unsigned mlen(0);
+	f8String mtype;
+	FieldIndex idx(from, sz);
+	if (!extract_header(idx, mlen, mtype))
+		throw InvalidMessage(f8String(from, sz));
+	const MsgTable::Pair *bmp(ctx.find_msg(mtype));
+	const Message *proto(bmp ? ctx.prototype(bmp) : 0);
+	if (!proto)
+		throw InvalidMessage(mtype);
+
+	const char *pp(sz < 7 ? 0 : from + sz - 7);
+	if (!pp || *pp != '1' || *(pp + 1) != '0') // 10=XXX^A
+		throw InvalidMessage(f8String(from, sz));
+	if (!ctx.has_flag(F8MetaCntx::noverifychksum)) // permit chksum calculation to be skipped
+	{
+		const unsigned chkval(fast_atoi<unsigned>(pp + 3, pp + 6)), mchkval(calc_chksum(from, sz, 0, sz - 7));
+		if (chkval != mchkval)
+			throw BadCheckSum(mchkval);
+	}
+
+	if (!vis.on_message_begin(mtype, bmp->_value))
+		return sz;
+#if defined CODECTIMING
+	IntervalTimer itm;
+#endif
+	const unsigned s_offset(proto->_trailer->visit(from, sz, proto->visit(from, sz,
+		proto->_header->visit(from, sz, 0, idx, vis), idx, vis), idx, vis));
+#if defined CODECTIMING
+	_decode_timings._cpu_used += itm.Calculate().AsDouble();
+	++_decode_timings._msg_count;
+#endif
+	vis.on_message_end();
+	return s_offset;
+}
+
+//-------------------------------------------------------------------------------------------------
+void Message::recycle(const F8MetaCntx& ctx, Message *msg)
+{
+	const MsgTable::Pair *bmp;
+	if (ctx._msg_pool_max && (bmp = ctx.find_msg(msg->get_msgtype())))
+	{
+		msg->clear(true);
+		if (ctx.get_msg_pool(bmp).put(msg, ctx._msg_pool_max))
+			return;
+	}
+	delete msg;
+}
+
+//-------------------------------------------------------------------------------------------------
+MsgPool::~MsgPool()
+{
+	std::for_each (_msgs.begin(), _msgs.end(), free_ptr<>());
+}
+
+//-------------------------------------------------------------------------------------------------
+GroupBase::~GroupBase()
+{
+	clear(false);
+	delete _proto;
+}
+
+//-------------------------------------------------------------------------------------------------
+Message **F8MetaCntx::build_prototypes() const
+{
+	f8_scoped_lock guard(_protos_mutex);
+	if (!_protos)
+	{
+		Message **protos(new Message *[_bme.size()]);
+		for (unsigned ii(0); ii < _bme.size(); ++ii)
+		{
+			Message *(*create)()((_bme.begin() + ii)->_value._create);
+			if (create == _mk_hdr || create == _mk_trl)	// header and trailer are not messages
+			{
+				protos[ii] = 0;
+				continue;
+			}
+			Message *msg(create());
+			msg->build_group_prototypes();
+			msg->Header()->build_group_prototypes();
+			msg->Trailer()->build_group_prototypes();
+			protos[ii] = msg;
+		}
+		_protos = protos;
+	}
+	return _protos;
+}
+
+//-------------------------------------------------------------------------------------------------
+F8MetaCntx::~F8MetaCntx()
+{
+	Message **protos(_protos);
+	if (protos)
+	{
+		for (unsigned ii(0); ii < _bme.size(); ++ii)
+			delete protos[ii];
+		delete[] protos;
+	}
+	delete[] _msg_pool;
+}
+
 //-------------------------------------------------------------------------------------------------
 // copy all fields from this message to 'to' where the field is legal for 'to' and it is not
 // already present in 'to'; includes repeating groups;
@@ -270,7 +626,7 @@ unsigned MessageBase::copy_legal(MessageBase *to, bool force) const
 	unsigned copied(0);
 	for (Presence::const_iterator itr(_fp.get_presence().begin()); itr != _fp.get_presence().end(); ++itr)
 	{
-		if (itr->_field_traits & FieldTrait::present && (force || (to->_fp.has(itr->_fnum) && !to->_fp.get(itr->_fnum))))
+		if (_fp.get(itr->_fnum, FieldTrait::present) && (force || (to->_fp.has(itr->_fnum) && !to->_fp.get(itr->_fnum))))
 		{
 			if (itr->_field_traits & FieldTrait::group)
 			{
@@ -304,17 +660,32 @@ unsigned MessageBase::copy_legal(MessageBase *to, bool force) const
 unsigned MessageBase::encode(char *to, size_t& sz) const
 {
 	const size_t where(sz);
-	for (Positions::const_iterator itr(_pos.begin()); itr != _pos.end(); ++itr)
+#if !defined POPULATE_METADATA
+	if (!_rawbuf && encode_specialised(to, sz))	// generated encoder, if any
+		return sz - where;
+#endif
+	for (Fields::const_iterator itr(_fields.begin()); itr != _fields.end(); ++itr)
 	{
+		if (!*itr)
+		{
+			const unsigned idx(itr - _fields.begin());
+			if (is_raw(idx) && !_fp.get(_raw[idx]._fnum, FieldTrait::suppress))	// untouched lazy field, copy through
+			{
+				::memcpy(to + sz, _rawbuf + _raw[idx]._offset, _raw[idx]._len);
+				sz += _raw[idx]._len;
+			}
+			continue;
+		}
 #if defined POPULATE_METADATA
-		check_set_rlm(itr->second);
+		check_set_rlm(*itr);
 #endif
+		const unsigned short fnum((*itr)->_fnum);
 		Presence::const_iterator fpitr(_fp.get_presence().end());
-		if (!_fp.get(itr->second->_fnum, fpitr, FieldTrait::suppress))	// some fields are not encoded until unsuppressed (eg. checksum)
+		if (!_fp.get(fnum, fpitr, FieldTrait::suppress))	// some fields are not encoded until unsuppressed (eg. checksum)
 		{
-			itr->second->encode(to, sz);
-			if (_fp.get(itr->second->_fnum, fpitr, FieldTrait::group))
-				encode_group(itr->second->_fnum, to, sz);
+			(*itr)->encode(to, sz, _ctx.tag_prefix(fnum));
+			if (_fp.get(fnum, fpitr, FieldTrait::group))
+				encode_group(fnum, to, sz);
 		}
 	}
 
@@ -325,17 +696,21 @@ unsigned MessageBase::encode(char *to, size_t& sz) const
 unsigned MessageBase::encode(ostream& to) const
 {
 	const std::ios::pos_type where(to.tellp());
-	for (Positions::const_iterator itr(_pos.begin()); itr != _pos.end(); ++itr)
+	materialise_all();
+	for (Fields::const_iterator itr(_fields.begin()); itr != _fields.end(); ++itr)
 	{
+		if (!*itr)
+			continue;
 #if defined POPULATE_METADATA
-		check_set_rlm(itr->second);
+		check_set_rlm(*itr);
 #endif
+		const unsigned short fnum((*itr)->_fnum);
 		Presence::const_iterator fpitr(_fp.get_presence().end());
-		if (!_fp.get(itr->second->_fnum, fpitr, FieldTrait::suppress))	// some fields are not encoded until unsuppressed (eg. checksum)
+		if (!_fp.get(fnum, fpitr, FieldTrait::suppress))	// some fields are not encoded until unsuppressed (eg. checksum)
 		{
-			itr->second->encode(to);
-			if (_fp.get(itr->second->_fnum, fpitr, FieldTrait::group))
-				encode_group(itr->second->_fnum, to);
+			(*itr)->encode(to);
+			if (_fp.get(fnum, fpitr, FieldTrait::group))
+				encode_group(fnum, to);
 		}
 	}
 
@@ -369,7 +744,16 @@ unsigned MessageBase::encode_group(const unsigned short fnum, std::ostream& to)
 //-------------------------------------------------------------------------------------------------
 unsigned Message::encode(f8String& to) const
 {
-	char msg[MAX_MSG_LENGTH], hmsg[MAX_MSG_LENGTH];
+	char buf[prefix_reserve + MAX_MSG_LENGTH], *frame;
+	const unsigned len(encode(buf, frame));
+	to.assign(frame, len);
+	return len;
+}
+
+//-------------------------------------------------------------------------------------------------
+unsigned Message::encode(char *to, char *& frame, const char *hdrblk, const size_t hdrlen) const
+{
+	char *msg(to + prefix_reserve), hmsg[MAX_FLD_LENGTH];
 	size_t sz(0), hsz(0);
 
 #if defined CODECTIMING
@@ -378,40 +762,59 @@ unsigned Message::encode(f8String& to) const
 
 	if (!_header)
 		throw MissingMessageComponent("header");
-	Fields::const_iterator fitr(_header->_fields.find(Common_MsgType));
-	static_cast<msg_type *>(fitr->second)->set(_msgType);
+	BaseField *fld(_header->get_field(Common_MsgType));
+	if (!fld)
+		throw MissingMandatoryField(Common_MsgType);
+	static_cast<msg_type *>(fld)->set(_msgType);
+
+	// running checksum: each section is summed as soon as it is written, while still in cache;
+	// the header template is copied and summed in one pass
 	_header->encode(msg, sz);
+	unsigned sum(sum_bytes(msg, sz));
+	if (hdrlen)
+	{
+		sum += copy_sum_bytes(msg + sz, hdrblk, hdrlen);
+		sz += hdrlen;
+	}
+	size_t where(sz);
 	MessageBase::encode(msg, sz);
+	sum += sum_bytes(msg + where, sz - where);
 	if (!_trailer)
 		throw MissingMessageComponent("trailer");
+	where = sz;
 	_trailer->encode(msg, sz);
+	sum += sum_bytes(msg + where, sz - where);
 	const unsigned msgLen(sz);	// checksummable msglength
 
-	if ((fitr = _header->_fields.find(Common_BeginString)) == _header->_fields.end())
+	if (!(fld = _header->get_field(Common_BeginString)))
 		throw MissingMandatoryField(Common_BeginString);
 	_header->_fp.clear(Common_BeginString, FieldTrait::suppress);
-	fitr->second->encode(hmsg, hsz);
+	fld->encode(hmsg, hsz, _ctx.tag_prefix(fld->get_tag()));
 #if defined MSGRECYCLING
 	_header->_fp.set(Common_BeginString, FieldTrait::suppress); // in case we want to reuse
 #endif
 
-	if ((fitr = _header->_fields.find(Common_BodyLength)) == _header->_fields.end())
+	if (!(fld = _header->get_field(Common_BodyLength)))
 		throw MissingMandatoryField(Common_BodyLength);
 	_header->_fp.clear(Common_BodyLength, FieldTrait::suppress);
-	static_cast<body_length *>(fitr->second)->set(msgLen);
-	fitr->second->encode(hmsg, hsz);
+	static_cast<body_length *>(fld)->set(msgLen);
+	fld->encode(hmsg, hsz, _ctx.tag_prefix(fld->get_tag()));
 #if defined MSGRECYCLING
 	_header->_fp.set(Common_BodyLength, FieldTrait::suppress); // in case we want to reuse
 #endif
 
-	::memcpy(hmsg + hsz, msg, sz);
-	hsz += sz;
+	// back-fill the prefix into the gap ahead of the body
+	if (hsz > prefix_reserve)
+		throw IllegalMessage("BeginString/BodyLength exceeds reserved prefix");
+	frame = msg - hsz;
+	::memcpy(frame, hmsg, hsz);
+	const unsigned chksum((sum + sum_bytes(hmsg, hsz)) % 256);	// only the back-filled prefix is summed here
 
-	if ((fitr = _trailer->_fields.find(Common_CheckSum)) == _trailer->_fields.end())
+	if (!(fld = _trailer->get_field(Common_CheckSum)))
 		throw MissingMandatoryField(Common_CheckSum);
-	static_cast<check_sum *>(fitr->second)->set(fmt_chksum(calc_chksum(hmsg, hsz)));
+	static_cast<check_sum *>(fld)->set(fmt_chksum(chksum));
 	_trailer->_fp.clear(Common_CheckSum, FieldTrait::suppress);
-	fitr->second->encode(hmsg, hsz);
+	fld->encode(msg, sz, _ctx.tag_prefix(fld->get_tag()));
 #if defined MSGRECYCLING
 	_trailer->_fp.set(Common_CheckSum, FieldTrait::suppress); // in case we want to reuse
 #endif
@@ -421,33 +824,36 @@ unsigned Message::encode(f8String& to) const
 	++_encode_timings._msg_count;
 #endif
 
-	to.assign(hmsg, hsz);
-	return to.size();
+	return hsz + sz;
 }
 
 //-------------------------------------------------------------------------------------------------
 void MessageBase::print(ostream& os, int depth) const
 {
 	const string dspacer((depth + 1) * 3, ' ');
+	materialise_all();
 	const BaseMsgEntry *tbme(_ctx._bme.find_ptr(_msgType));
 	if (tbme)
 		os << tbme->_name << " (\"" << _msgType << "\")" << endl;
-	for (Positions::const_iterator itr(_pos.begin()); itr != _pos.end(); ++itr)
+	for (Fields::const_iterator itr(_fields.begin()); itr != _fields.end(); ++itr)
 	{
-		const BaseEntry *tbe(_ctx._be.find_ptr(itr->second->_fnum));
+		if (!*itr)
+			continue;
+		const BaseField& fld(**itr);
+		const BaseEntry *tbe(_ctx._be.find_ptr(fld._fnum));
 		if (!tbe)
 #if defined PERMIT_CUSTOM_FIELDS
-			if (!_ctx._ube || (tbe = _ctx._ube->find_ptr(itr->second->_fnum)) == 0)
+			if (!_ctx._ube || (tbe = _ctx._ube->find_ptr(fld._fnum)) == 0)
 #endif
-				throw InvalidField(itr->second->_fnum);
-		os << dspacer << tbe->_name << " (" << itr->second->_fnum << "): ";
+				throw InvalidField(fld._fnum);
+		os << dspacer << tbe->_name << " (" << fld._fnum << "): ";
 		int idx;
-		if (itr->second->_rlm && (idx = (itr->second->get_rlm_idx())) >= 0)
-			os << itr->second->_rlm->_descriptions[idx] << " (" << *itr->second << ')' << endl;
+		if (fld._rlm && (idx = (fld.get_rlm_idx())) >= 0)
+			os << fld._rlm->_descriptions[idx] << " (" << fld << ')' << endl;
 		else
-			os << *itr->second << endl;
-		if (_fp.is_group(itr->second->_fnum))
-			print_group(itr->second->_fnum, os, depth);
+			os << fld << endl;
+		if (_fp.is_group(fld._fnum))
+			print_group(fld._fnum, os, depth);
 	}
 }
 
@@ -470,8 +876,8 @@ void MessageBase::print_group(const unsigned short fnum, ostream& os, int depth)
 //-------------------------------------------------------------------------------------------------
 void MessageBase::print_field(const unsigned short fnum, ostream& os) const
 {
-	Fields::const_iterator fitr(_fields.find(fnum));
-	if (fitr != _fields.end())
+	const BaseField *fld(get_field(fnum));
+	if (fld)
 	{
 		const BaseEntry *tbe(_ctx._be.find_ptr(fnum));
 		if (!tbe)
@@ -481,10 +887,10 @@ void MessageBase::print_field(const unsigned short fnum, ostream& os) const
 				throw InvalidField(fnum);
 		os << tbe->_name << " (" << fnum << "): ";
 		int idx;
-		if (fitr->second->_rlm && (idx = (fitr->second->get_rlm_idx())) >= 0)
-			os << fitr->second->_rlm->_descriptions[idx] << " (" << *fitr->second << ')';
+		if (fld->_rlm && (idx = (fld->get_rlm_idx())) >= 0)
+			os << fld->_rlm->_descriptions[idx] << " (" << *fld << ')';
 		else
-			os << *fitr->second;
+			os << *fld;
 		if (_fp.is_group(fnum))
 			print_group(fnum, os, 0);
 	}
@@ -493,48 +899,20 @@ void MessageBase::print_field(const unsigned short fnum, ostream& os) const
 //-------------------------------------------------------------------------------------------------
 BaseField *MessageBase::replace(const unsigned short fnum, BaseField *with)
 {
-	BaseField *old(0);
-	Fields::iterator itr(_fields.find(fnum));
-	if (itr != _fields.end())
-	{
-		old = itr->second;
-		unsigned pos(_fp.getPos(fnum));
-		for (Positions::iterator pitr(_pos.begin()); pitr != _pos.end(); ++pitr)
-		{
-			if (pitr->second == old)
-			{
-				pos = pitr->first;
-				_pos.erase(pitr);
-				break;
-			}
-		}
-		_pos.insert(Positions::value_type(pos, with));
-		itr->second = with;
-		_fp.set(fnum, FieldTrait::present);
-	}
-	return old;
+	Presence::const_iterator fitr(_fp.get_presence().end());
+	return replace(fnum, fitr, with);
 }
 
 //-------------------------------------------------------------------------------------------------
 BaseField *MessageBase::replace(const unsigned short fnum, Presence::const_iterator fitr, BaseField *with)
 {
 	BaseField *old(0);
-	Fields::iterator itr(_fields.find(fnum));
-	if (itr != _fields.end())
+	const unsigned short fpos(_fp.getPos(fnum, fitr));
+	if (fpos && is_raw(fpos - 1))
+		materialise(fpos - 1);
+	if (fpos && (old = _fields[fpos - 1]))
 	{
-		old = itr->second;
-		unsigned pos(_fp.getPos(fnum, fitr));
-		for (Positions::iterator pitr(_pos.begin()); pitr != _pos.end(); ++pitr)
-		{
-			if (pitr->second == old)
-			{
-				pos = pitr->first;
-				_pos.erase(pitr);
-				break;
-			}
-		}
-		_pos.insert(Positions::value_type(pos, with));
-		itr->second = with;
+		_fields[fpos - 1] = with;
 		_fp.set(fnum, fitr, FieldTrait::present);
 	}
 	return old;
@@ -543,43 +921,21 @@ BaseField *MessageBase::replace(const unsigned short fnum, Presence::const_itera
 //-------------------------------------------------------------------------------------------------
 BaseField *MessageBase::remove(const unsigned short fnum)
 {
-	BaseField *old(0);
-	Fields::iterator itr(_fields.find(fnum));
-	if (itr != _fields.end())
-	{
-		old = itr->second;
-		for (Positions::iterator pitr(_pos.begin()); pitr != _pos.end(); ++pitr)
-		{
-			if (pitr->second == old)
-			{
-				_pos.erase(pitr);
-				break;
-			}
-		}
-		_fp.clear(fnum, FieldTrait::present);
-		_fields.erase(itr);
-	}
-	return old;
+	Presence::const_iterator fitr(_fp.get_presence().end());
+	return remove(fnum, fitr);
 }
 
 //-------------------------------------------------------------------------------------------------
 BaseField *MessageBase::remove(const unsigned short fnum, Presence::const_iterator fitr)
 {
 	BaseField *old(0);
-	Fields::iterator itr(_fields.find(fnum));
-	if (itr != _fields.end())
+	const unsigned short fpos(_fp.getPos(fnum, fitr));
+	if (fpos && is_raw(fpos - 1))
+		materialise(fpos - 1);
+	if (fpos && (old = _fields[fpos - 1]))
 	{
-		old = itr->second;
-		for (Positions::iterator pitr(_pos.begin()); pitr != _pos.end(); ++pitr)
-		{
-			if (pitr->second == old)
-			{
-				_pos.erase(pitr);
-				break;
-			}
-		}
+		_fields[fpos - 1] = 0;
 		_fp.clear(fnum, fitr, FieldTrait::present);
-		_fields.erase(itr);
 	}
 	return old;
 }
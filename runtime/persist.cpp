@@ -303,8 +303,8 @@ int BDBPersister::operator()()
 			if (!_persist_queue.try_pop(buffer))
 				break;
 		}
-		else
-			_persist_queue.pop (buffer); // will block
+		else if (!_wait.pop(_persist_queue, buffer))
+			continue;
 		msg_ptr = &buffer;
 
       if (buffer.empty())  // means exit
@@ -313,16 +313,10 @@ int BDBPersister::operator()()
 			continue;
 		}
 #else
-		if (_msg_queue.try_pop (msg_ptr)) // will not block
-		{
-			if (msg_ptr->empty())  // means exit
-				break;
-		}
-		else
-		{
-			hypersleep<h_nanoseconds>(250);
+		if (!_wait.pop(_persist_queue, msg_ptr))
 			continue;
-		}
+		if (msg_ptr->empty())  // means exit
+			break;
 #endif
 
 		//cout << "persisted..." << endl;
@@ -343,7 +337,7 @@ int BDBPersister::operator()()
 				++persisted;
 		}
 #if (MPMC_SYSTEM == MPMC_FF)
-		_msg_queue.release(msg_ptr);
+		_persist_queue.release(msg_ptr);
 #endif
 	}
 
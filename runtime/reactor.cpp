@@ -0,0 +1,328 @@
+//-------------------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+//-------------------------------------------------------------------------------------------------
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <list>
+#include <set>
+#include <iterator>
+#include <memory>
+#include <iomanip>
+#include <algorithm>
+
+#include <strings.h>
+#include <regex.h>
+
+#include <f8includes.hpp>
+
+#if defined HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+using namespace FIX8;
+using namespace std;
+
+//-------------------------------------------------------------------------------------------------
+namespace FIX8
+{
+	template<>
+	f8_atomic<Reactor *> Singleton<Reactor>::_instance = f8_atomic<Reactor *>();
+	template<>
+	f8_mutex Singleton<Reactor>::_mutex = f8_mutex();
+}
+
+namespace
+{
+	/// The handler being dispatched by this reactor thread, if any.
+	__thread const ReactorHandler *_dispatching;
+
+	/// Set in reactor threads.
+	__thread bool _in_reactor;
+}
+
+//-------------------------------------------------------------------------------------------------
+Reactor::Reactor() : _epfd(-1), _nthreads(default_threads), _tick_ms(default_tick_ms)
+{
+	_stopping = false;
+#if defined HAVE_SYS_EPOLL_H
+	if ((_epfd = epoll_create(_max_events)) < 0)
+		throw f8Exception("epoll_create failed");
+#else
+	throw f8Exception("epoll reactor not supported on this platform");
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+Reactor::~Reactor()
+{
+	_stopping = true;
+	for (vector<dthread<Reactor> *>::iterator itr(_threads.begin()); itr != _threads.end(); ++itr)
+	{
+		(*itr)->join();
+		delete *itr;
+	}
+	if (_epfd >= 0)
+		close(_epfd);
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::configure(const unsigned threads, const unsigned tick_ms)
+{
+	f8_scoped_lock guard(_mutex);
+	if (!_threads.empty())
+		return false;
+	_nthreads = threads ? threads : static_cast<unsigned>(default_threads);
+	_tick_ms = tick_ms ? tick_ms : static_cast<unsigned>(default_tick_ms);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::add(const int fd, ReactorHandler *handler)
+{
+#if defined HAVE_SYS_EPOLL_H
+	f8_scoped_lock guard(_mutex);
+	if (_entries.find(handler) != _entries.end())
+		return false;
+
+	if (_threads.empty())
+	{
+		for (unsigned ii(0); ii < _nthreads; ++ii)
+		{
+			_threads.push_back(new dthread<Reactor>(ref(*this)));
+			_threads.back()->start();
+		}
+		ostringstream ostr;
+		ostr << "Reactor started with " << _nthreads << " thread(s), tick " << _tick_ms << "ms";
+		GlobalLogger::log(ostr.str());
+	}
+
+	if (!arm(fd, handler, true))
+		return false;
+	_entries.insert(Entries::value_type(handler, Entry(fd)));
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::remove(ReactorHandler *handler)
+{
+	bool found(false);
+
+	for (;;)
+	{
+		{
+			f8_scoped_lock guard(_mutex);
+			Entries::iterator itr(_entries.find(handler));
+			if (itr == _entries.end())
+				return found;
+			if (!itr->second._removed)
+			{
+#if defined HAVE_SYS_EPOLL_H
+				epoll_ctl(_epfd, EPOLL_CTL_DEL, itr->second._fd, 0);
+#endif
+				itr->second._removed = found = true;
+			}
+			if (!itr->second._busy)
+			{
+				_entries.erase(itr);
+				return found;
+			}
+			if (_dispatching == handler)	// called from our own callback; release() will erase
+				return found;
+		}
+		hypersleep<h_microseconds>(100);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::acquire(ReactorHandler *handler)
+{
+	f8_scoped_lock guard(_mutex);
+	Entries::iterator itr(_entries.find(handler));
+	if (itr == _entries.end() || itr->second._removed)
+		return false;
+	if (itr->second._busy)	// only a tick can hold it; re-arming now would spin until the tick is done
+	{
+		itr->second._pending = true;
+		return false;
+	}
+	return itr->second._busy = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+void Reactor::release(ReactorHandler *handler, const bool keep)
+{
+	f8_scoped_lock guard(_mutex);
+	Entries::iterator itr(_entries.find(handler));
+	if (itr == _entries.end())
+		return;
+	itr->second._busy = itr->second._pending = false;
+	if (!itr->second._removed && keep && arm(itr->second._fd, handler))
+		return;
+
+#if defined HAVE_SYS_EPOLL_H
+	if (!itr->second._removed)
+		epoll_ctl(_epfd, EPOLL_CTL_DEL, itr->second._fd, 0);
+#endif
+	_entries.erase(itr);
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::arm(const int fd, ReactorHandler *handler, const bool first)
+{
+#if defined HAVE_SYS_EPOLL_H
+	epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLONESHOT;	// one thread per readiness; re-armed after dispatch
+	ev.data.ptr = handler;
+	return epoll_ctl(_epfd, first ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) == 0;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+void Reactor::tick()
+{
+	vector<ReactorHandler *> due;
+
+	{
+		f8_scoped_lock guard(_mutex);
+		Tickval now(true);
+		if (now < _next_tick)
+			return;
+		_next_tick = now;
+		_next_tick += _tick_ms * Tickval::million;
+
+		for (Entries::iterator itr(_entries.begin()); itr != _entries.end(); ++itr)
+		{
+			if (!itr->second._removed && !itr->second._busy)	// busy handlers catch the next tick
+			{
+				itr->second._busy = true;
+				due.push_back(itr->first);
+			}
+		}
+	}
+
+	for (vector<ReactorHandler *>::iterator itr(due.begin()); itr != due.end(); ++itr)
+	{
+		_dispatching = *itr;
+		try
+		{
+			(*itr)->on_tick();
+		}
+		catch (exception& e)
+		{
+			GlobalLogger::log(e.what());
+		}
+		_dispatching = 0;
+
+		f8_scoped_lock guard(_mutex);
+		Entries::iterator eitr(_entries.find(*itr));
+		if (eitr != _entries.end())
+		{
+			eitr->second._busy = false;
+			if (eitr->second._removed)
+				_entries.erase(eitr);
+			else if (eitr->second._pending)	// readable while we were ticking
+			{
+				eitr->second._pending = false;
+				arm(eitr->second._fd, *itr);
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Reactor::is_reactor_thread()
+{
+	return _in_reactor;
+}
+
+//-------------------------------------------------------------------------------------------------
+int Reactor::operator()()
+{
+#if defined HAVE_SYS_EPOLL_H
+	unsigned dispatched(0);
+	epoll_event events[_max_events];
+	_in_reactor = true;
+
+	while (!_stopping)
+	{
+		const int cnt(epoll_wait(_epfd, events, _max_events, _tick_ms));
+		if (cnt < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			GlobalLogger::log("Reactor: epoll_wait failed");
+			return -1;
+		}
+
+		for (int ii(0); ii < cnt; ++ii)
+		{
+			ReactorHandler *handler(static_cast<ReactorHandler *>(events[ii].data.ptr));
+			if (!acquire(handler))	// removed, or being ticked on another thread and re-armed when that is done
+				continue;
+
+			bool keep(false);
+			_dispatching = handler;
+			try
+			{
+				keep = handler->on_readable();
+			}
+			catch (exception& e)
+			{
+				GlobalLogger::log(e.what());
+			}
+			_dispatching = 0;
+			release(handler, keep);
+			++dispatched;
+		}
+
+		tick();
+	}
+
+	ostringstream ostr;
+	ostr << "Reactor thread terminating (" << dispatched << " events dispatched)";
+	GlobalLogger::log(ostr.str());
+#endif
+	return 0;
+}
+
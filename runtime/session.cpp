@@ -120,19 +120,27 @@ void SessionID::from_string(const f8String& from)
 //-------------------------------------------------------------------------------------------------
 Session::Session(const F8MetaCntx& ctx, const SessionID& sid, Persister *persist, Logger *logger, Logger *plogger) :
 	_ctx(ctx), _connection(), _req_next_send_seq(), _req_next_receive_seq(),
-	_sid(sid), _persist(persist), _logger(logger), _plogger(plogger),	// initiator
-	_timer(*this, 1), _hb_processor(&Session::heartbeat_service)
+	_sid(sid), _persist(persist), _logger(logger), _plogger(plogger), _visitor(), _interest(),	// initiator
+	_timer(*this, 1), _hb_processor(&Session::heartbeat_service), _timer_started()
 {
-	_timer.start();
+	index_handlers();
 }
 
 //-------------------------------------------------------------------------------------------------
 Session::Session(const F8MetaCntx& ctx, Persister *persist, Logger *logger, Logger *plogger) :
 	_ctx(ctx), _connection(), _req_next_send_seq(), _req_next_receive_seq(),
-	_sf(), _persist(persist), _logger(logger), _plogger(plogger),	// acceptor
-	_timer(*this, 1), _hb_processor(&Session::heartbeat_service)
+	_sf(), _persist(persist), _logger(logger), _plogger(plogger), _visitor(), _interest(),	// acceptor
+	_timer(*this, 1), _hb_processor(&Session::heartbeat_service), _timer_started()
 {
-	_timer.start();
+	index_handlers();
+}
+
+//-------------------------------------------------------------------------------------------------
+void Session::index_handlers()
+{
+	_handler_index.reserve(_ctx._bme.size());
+	for (const MsgTable::Pair *itr(_ctx._bme.begin()); itr != _ctx._bme.end(); ++itr)
+		_handler_index.push_back(_handlers.find_ref(itr->_key));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -154,7 +162,7 @@ Session::~Session()
 		hypersleep<h_seconds>(1);
 	}
 
-	if (_connection->get_role() == Connection::cn_acceptor)
+	if (_connection && _connection->get_role() == Connection::cn_acceptor)
 	{
 		delete _plogger;
 		delete _logger;
@@ -177,6 +185,11 @@ int Session::start(Connection *connection, bool wait, const unsigned send_seqnum
 		return -1;;
 	if (_connection->get_role() == Connection::cn_acceptor)
 		atomic_init(States::st_wait_for_logon); // important for server that this is done before connect
+	if (!_connection->is_reactive() && !_timer_started) // reactor sessions have their timer serviced by the reactor
+	{
+		_timer.start();
+		_timer_started = true;
+	}
 	_connection->start();
 	log("Session connected");
 
@@ -230,7 +243,8 @@ void Session::stop()
 			_persist->stop();
 	}
 	_connection->stop();
-	hypersleep<h_milliseconds>(250);
+	if (!Reactor::is_reactor_thread())	// don't hold up other sessions serviced by this reactor
+		hypersleep<h_milliseconds>(250);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -254,14 +268,14 @@ bool Session::process(const f8String& from)
 
 	try
 	{
-		const f8String::size_type fpos(from.find("34="));
-		if (fpos == f8String::npos)
+		RawHeader hdr;
+		if (!scan_header(from, hdr))
 		{
 			//cerr << "Session::process throwing for " << from << endl;
 			throw InvalidMessage(from);
 		}
 
-		seqnum = fast_atoi<unsigned>(from.data() + fpos + 3, default_field_separator);
+		seqnum = hdr._seqnum;
 
 		bool retry_plog(false);
 		if (_state != States::st_wait_for_logon)
@@ -269,24 +283,37 @@ bool Session::process(const f8String& from)
 		else
 			retry_plog = true;
 
-		scoped_ptr<Message> msg(Message::factory(_ctx, from));
-		if (!msg.get())
+		bool result(true), advance(true);
+		if (_visitor && is_application(hdr))
 		{
-			GlobalLogger::log("Fatal: factory failed to generate a valid message");
-			return false;
+			// a visited message that fails the session checks is neither visited nor counted
+			if ((advance = !enforce(hdr, from)))
+				result = Message::decode(_ctx, from.data(), from.size(), *_visitor) > 0;
 		}
+		else
+		{
+			scoped_msg msg(_ctx, Message::factory(_ctx, from, _interest));
+			if (!msg.get())
+			{
+				GlobalLogger::log("Fatal: factory failed to generate a valid message");
+				return false;
+			}
 
-		if (_control & print)
-			cout << *msg << endl;
-		bool result((msg->is_admin() ? handle_admin(seqnum, msg.get()) : true)
-			&& (this->*_handlers.find_ref(msg->get_msgtype()))(seqnum, msg.get()));
-		++_next_receive_seq;
+			if (_control & print)
+				cout << *msg << endl;
+			result = (msg->is_admin() ? handle_admin(seqnum, msg.get()) : true)
+				&& (this->*_handler_index[_ctx.msg_index(_ctx.find_msg(msg->get_msgtype()))])(seqnum, msg.get());
+		}
 		if (retry_plog)
 			plog(from, 1);
-		if (_persist)
+		if (advance)
 		{
-			_persist->put(_next_send_seq, _next_receive_seq);
-			//cout << "Persisted:" << _next_send_seq << " and " << _next_receive_seq << endl;
+			++_next_receive_seq;
+			if (_persist)
+			{
+				_persist->put(_next_send_seq, _next_receive_seq);
+				//cout << "Persisted:" << _next_send_seq << " and " << _next_receive_seq << endl;
+			}
 		}
 		return result;
 
@@ -321,17 +348,80 @@ bool Session::process(const f8String& from)
 	return false;
 }
 
+//-------------------------------------------------------------------------------------------------
+bool Session::scan_header(const f8String& from, RawHeader& hdr)
+{
+	const char *ptr(from.data()), *const eptr(ptr + from.size());
+	for (unsigned found(0); found < 4 && ptr < eptr;)
+	{
+		const char *eq(static_cast<const char *>(::memchr(ptr, '=', eptr - ptr)));
+		if (!eq)
+			break;
+		const char *val(eq + 1), *eval(static_cast<const char *>(::memchr(val, default_field_separator, eptr - val)));
+		if (!eval)
+			eval = eptr;
+		const unsigned len(static_cast<unsigned>(eval - val));
+		switch (fast_atoi<unsigned>(ptr, eq))
+		{
+		case Common_MsgSeqNum: hdr._seqnum = fast_atoi<unsigned>(val, eval); ++found; break;
+		case Common_MsgType: hdr._msgtype = val; hdr._msgtype_len = len; ++found; break;
+		case Common_SenderCompID: hdr._sender = val; hdr._sender_len = len; ++found; break;
+		case Common_TargetCompID: hdr._target = val; hdr._target_len = len; ++found; break;
+		default: break;
+		}
+		ptr = eval + 1;
+	}
+
+	return hdr._seqnum;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Session::is_application(const RawHeader& hdr) const
+{
+	if (!hdr._msgtype)
+		return false;
+	const MsgTable::Pair *bmp(_ctx.find_msg(hdr._msgtype, hdr._msgtype_len));
+	return bmp && _handler_index[_ctx.msg_index(bmp)] == &Session::handle_application;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool Session::enforce(const RawHeader& hdr, const f8String& from)
+{
+	if (!States::is_established(_state))
+		return true;
+
+	if (_state != States::st_logon_received)
+	{
+		if (!hdr._sender || !hdr._target)
+			throw BadCompidId(hdr._sender ? f8String(hdr._sender, hdr._sender_len)
+				: hdr._target ? f8String(hdr._target, hdr._target_len) : f8String());
+		const f8String& sender(_sid.get_senderCompID().get()), & target(_sid.get_targetCompID().get());
+		if (hdr._target_len != sender.size() || ::memcmp(hdr._target, sender.data(), sender.size()))
+			throw BadCompidId(f8String(hdr._sender, hdr._sender_len));
+		if (hdr._sender_len != target.size() || ::memcmp(hdr._sender, target.data(), target.size()))
+			throw BadCompidId(f8String(hdr._target, hdr._target_len));
+	}
+
+	if (hdr._seqnum < _next_receive_seq)
+	{
+		scoped_msg msg(_ctx, Message::factory(_ctx, from));
+		return !msg.get() || !sequence_check(hdr._seqnum, msg.get());
+	}
+
+	return !sequence_check(hdr._seqnum, 0);
+}
+
 //-------------------------------------------------------------------------------------------------
 void Session::compid_check(const unsigned seqnum, const Message *msg)
 {
-	sender_comp_id sci;
-	msg->Header()->get(sci);
-	target_comp_id tci;
-	msg->Header()->get(tci);
-	if (!_sid.same_sender_comp_id(tci))
-		throw BadCompidId(sci());
-	if (!_sid.same_target_comp_id(sci))
-		throw BadCompidId(tci());
+	const sender_comp_id *sci(msg->Header()->get<sender_comp_id>());
+	const target_comp_id *tci(msg->Header()->get<target_comp_id>());
+	if (!sci || !tci)
+		throw BadCompidId(sci ? sci->get() : tci ? tci->get() : f8String());
+	if (!_sid.same_sender_comp_id(*tci))
+		throw BadCompidId(sci->get());
+	if (!_sid.same_target_comp_id(*sci))
+		throw BadCompidId(tci->get());
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -427,6 +517,7 @@ bool Session::handle_logon(const unsigned seqnum, const Message *msg)
 		if (authenticate(id, msg))
 		{
 			_sid = id;
+			_hdr_tmpl.clear();
 			enforce(seqnum, msg);
 			Message *msg(generate_logon(_connection->get_hb_interval(), davi()));
 			send(msg);
@@ -728,11 +819,75 @@ bool Session::send_wait(Message *msg, const unsigned custom_seqnum, const int wa
 
 #endif
 
+//-------------------------------------------------------------------------------------------------
+size_t HeaderTemplate::put_tag(char *to, const unsigned tag, const TagPrefix *pfx)
+{
+	if (pfx && pfx->_len)
+	{
+		::memcpy(to, pfx->_str, pfx->_len);
+		return pfx->_len;
+	}
+	size_t sz(itoa(tag, to));
+	to[sz++] = '=';
+	return sz;
+}
+
+//-------------------------------------------------------------------------------------------------
+void HeaderTemplate::render(const F8MetaCntx& ctx, const SessionID& sid)
+{
+	// room for the tags, MsgSeqNum digits and SendingTime
+	if (sid.get_senderCompID()().size() + sid.get_targetCompID()().size() + 64 > _max_len)
+		throw f8Exception("header template exceeds maximum length");
+	_fixed = 0;
+	sid.get_senderCompID().encode(_buf, _fixed, ctx.tag_prefix(Common_SenderCompID));
+	sid.get_targetCompID().encode(_buf, _fixed, ctx.tag_prefix(Common_TargetCompID));
+	_fixed += put_tag(_buf + _fixed, Common_MsgSeqNum, ctx.tag_prefix(Common_MsgSeqNum));
+	_st_pfx = ctx.tag_prefix(Common_SendingTime);
+	_len = 0;
+	_last_sec = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+size_t HeaderTemplate::patch(const unsigned seqnum, const Tickval& now)
+{
+	size_t sz(_fixed);
+	sz += itoa(seqnum, _buf + sz);
+	_buf[sz++] = default_field_separator;
+	sz += put_tag(_buf + sz, Common_SendingTime, _st_pfx);
+
+	const unsigned secs(now.secs());
+	if (secs != _last_sec)
+	{
+		const time_t tval(secs);
+		tm tms;
+		::gmtime_r(&tval, &tms);
+		::strftime(_sec_str, _sec_len + 1, "%Y%m%d-%H:%M:%S", &tms);
+		_last_sec = secs;
+	}
+	::memcpy(_buf + sz, _sec_str, _sec_len);
+	sz += _sec_len;
+	unsigned msecs(now.nsecs() / Tickval::million);
+	_buf[sz++] = '.';
+	_buf[sz + 2] = msecs % 10 + '0';
+	msecs /= 10;
+	_buf[sz + 1] = msecs % 10 + '0';
+	_buf[sz] = msecs / 10 + '0';
+	sz += 3;
+	_buf[sz++] = default_field_separator;
+	return _len = sz;
+}
+
 //-------------------------------------------------------------------------------------------------
 bool Session::send_process(Message *msg) // called from the connection (possibly on separate thread)
 {
 	bool is_dup(msg->Header()->have(Common_PossDupFlag));
 
+	// header fast path: session supplied fields come from the pre-rendered template
+	if (_loginParamaters._header_template && !is_dup && !msg->Header()->have(Common_MsgSeqNum)
+		&& !msg->Header()->have(Common_SenderCompID) && !msg->Header()->have(Common_TargetCompID)
+		&& !msg->Header()->have(Common_SendingTime))
+		return send_process_template(msg);
+
 	if (!msg->Header()->have(Common_SenderCompID))
 		*msg->Header() += new sender_comp_id(_sid.get_senderCompID());
 	if (!msg->Header()->have(Common_TargetCompID))
@@ -761,36 +916,36 @@ bool Session::send_process(Message *msg) // called from the connection (possibly
 	{
 		//cout << "Sending:" << *msg;
 		modify_outbound(msg);
-		f8String output;
+		OutboundFrame output;
 		const unsigned enclen(msg->encode(output));
-		if (!_connection->send(output))
-		{
-			ostringstream ostr;
-			ostr << "Message write failed: " << enclen;
-			log(ostr.str());
+		if (!send_frame(msg, output, enclen, is_dup))
 			return false;
-		}
 		_last_sent.now();
-		plog(output);
-
 		//cout << "send_process" << endl;
+	}
+	catch (f8Exception& e)
+	{
+		log(e.what());
+	}
 
-		if (!is_dup)
-		{
-			if (_persist)
-			{
-				if (!msg->is_admin())
-					_persist->put(_next_send_seq, output);
-				_persist->put(_next_send_seq + 1, _next_receive_seq);
-				//cout << "Persisted (send):" << (_next_send_seq + 1) << " and " << _next_receive_seq << endl;
-			}
+	return true;
+}
 
-			if (!msg->get_custom_seqnum() && !msg->get_no_increment() && msg->get_msgtype() != Common_MsgType_SEQUENCE_RESET)
-			{
-				++_next_send_seq;
-				//cout << "Seqnum now:" << _next_send_seq << " and " << _next_receive_seq << endl;
-			}
-		}
+//-------------------------------------------------------------------------------------------------
+bool Session::send_process_template(Message *msg)
+{
+	try
+	{
+		modify_outbound(msg);
+		if (_hdr_tmpl.empty())
+			_hdr_tmpl.render(_ctx, _sid);
+		const unsigned seqnum(msg->get_custom_seqnum() ? msg->get_custom_seqnum() : static_cast<unsigned>(_next_send_seq));
+		_last_sent.now();
+		_hdr_tmpl.patch(seqnum, _last_sent);
+		OutboundFrame output;
+		const unsigned enclen(msg->encode(output, _hdr_tmpl.data(), _hdr_tmpl.size()));
+		if (!send_frame(msg, output, enclen, false))
+			return false;
 	}
 	catch (f8Exception& e)
 	{
@@ -800,6 +955,38 @@ bool Session::send_process(Message *msg) // called from the connection (possibly
 	return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+bool Session::send_frame(const Message *msg, const OutboundFrame& output, const unsigned enclen, const bool is_dup)
+{
+	if (!_connection->send(output.data(), enclen))
+	{
+		ostringstream ostr;
+		ostr << "Message write failed: " << enclen;
+		log(ostr.str());
+		return false;
+	}
+	plog(output);
+
+	if (!is_dup)
+	{
+		if (_persist)
+		{
+			if (!msg->is_admin())
+				_persist->put(_next_send_seq, output);
+			_persist->put(_next_send_seq + 1, _next_receive_seq);
+			//cout << "Persisted (send):" << (_next_send_seq + 1) << " and " << _next_receive_seq << endl;
+		}
+
+		if (!msg->get_custom_seqnum() && !msg->get_no_increment() && msg->get_msgtype() != Common_MsgType_SEQUENCE_RESET)
+		{
+			++_next_send_seq;
+			//cout << "Seqnum now:" << _next_send_seq << " and " << _next_receive_seq << endl;
+		}
+	}
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 bool Session::handle_application(const unsigned seqnum, const Message *msg)
 {
@@ -65,7 +65,104 @@ ostream& FIX8::operator<<(ostream& os, const FIX8::FieldTrait& what)
 //-------------------------------------------------------------------------------------------------
 ostream& FIX8::operator<<(ostream& os, const FIX8::FieldTraits& what)
 {
-	copy(what.get_presence().begin(), what.get_presence().end(), ostream_iterator<FieldTrait>(os, "\n"));
+	for (Presence::const_iterator itr(what.get_presence().begin()); itr != what.get_presence().end(); ++itr)
+		os << "Tag: " << itr->_fnum << " Type: " << itr->_ftype << " Flags: " << what.getval(itr) << endl;
 	return os;
 }
 
+//-------------------------------------------------------------------------------------------------
+void FieldTraits::resize_bits(const unsigned words)
+{
+	if (words == _words)
+		return;
+	TraitBits *bits(words <= inline_words ? _inline : new TraitBits[bit_sets * words]);
+	if (bits == _bits)	// inline to inline; move the sets apart from the top down
+	{
+		for (int set(bit_sets - 1); set >= 0; --set)
+			for (int ww(words - 1); ww >= 0; --ww)
+				bits[set * words + ww] = static_cast<unsigned>(ww) < _words ? _bits[set * _words + ww] : 0;
+	}
+	else
+	{
+		for (unsigned set(0); set < bit_sets; ++set)
+			for (unsigned ww(0); ww < words; ++ww)
+				bits[set * words + ww] = ww < _words ? _bits[set * _words + ww] : 0;
+		if (_bits != _inline)
+			delete[] _bits;
+	}
+	_bits = bits;
+	_words = words;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FieldTraits::init_bits()
+{
+	resize_bits(trait_words(_presence.size()));
+	const FieldTrait_Hash_Array *ftha(_presence.get_ftha());
+	if (ftha && ftha->_els == _presence.size())	// shared schema masks
+	{
+		_max_pos = ftha->_max_pos;
+		std::copy(ftha->_masks, ftha->_masks + _words, bitset(FieldTrait::mandatory));
+		std::copy(ftha->_masks + _words, ftha->_masks + 2 * _words, bitset(FieldTrait::suppress));
+		std::fill(bitset(FieldTrait::present), bitset(FieldTrait::present) + _words, 0);
+		return;
+	}
+	std::fill(_bits, _bits + bit_sets * _words, 0);
+	for (Presence::const_iterator itr(_presence.begin()); itr != _presence.end(); ++itr)
+	{
+		const size_t idx(index(itr));
+		const TraitBits bit(1ULL << idx % trait_bits_per_word);
+		if (itr->_field_traits.has(FieldTrait::mandatory))
+			bitset(FieldTrait::mandatory)[idx / trait_bits_per_word] |= bit;
+		if (itr->_field_traits.has(FieldTrait::suppress))
+			bitset(FieldTrait::suppress)[idx / trait_bits_per_word] |= bit;
+		if (itr->_field_traits.has(FieldTrait::position) && itr->_pos > _max_pos)
+			_max_pos = itr->_pos;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+bool FieldTraits::add(const FieldTrait& what)
+{
+	if (!_presence.insert(&what).second)
+		return false;
+	resize_bits(trait_words(_presence.size()));
+
+	// open a gap at the new trait's index in each bitset
+	const size_t idx(index(_presence.find(what._fnum)));
+	const unsigned iw(idx / trait_bits_per_word);
+	const TraitBits below((1ULL << idx % trait_bits_per_word) - 1);
+	for (unsigned set(0); set < bit_sets; ++set)
+	{
+		TraitBits *bs(_bits + set * _words);
+		for (unsigned ww(_words - 1); ww > iw; --ww)
+			bs[ww] = bs[ww] << 1 | bs[ww - 1] >> (trait_bits_per_word - 1);
+		bs[iw] = (bs[iw] & below) | (bs[iw] & ~below) << 1;
+	}
+
+	Presence::const_iterator itr(_presence.begin() + idx);
+	if (what._field_traits.has(FieldTrait::position) && what._pos > _max_pos)
+		_max_pos = what._pos;
+	if (what._field_traits.has(FieldTrait::mandatory))
+		assign(itr, FieldTrait::mandatory, true);
+	if (what._field_traits.has(FieldTrait::suppress))
+		assign(itr, FieldTrait::suppress, true);
+	if (what._field_traits.has(FieldTrait::present))
+		assign(itr, FieldTrait::present, true);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool FieldTraits::set_pos(const unsigned short field, const unsigned short pos)
+{
+	if (_presence.find(field) == _presence.end())
+		return false;
+	_presence.unshare();
+	Presence::iterator itr(_presence.find(field));
+	itr->_pos = pos;
+	itr->_field_traits.set(FieldTrait::position);
+	if (pos > _max_pos)
+		_max_pos = pos;
+	return true;
+}
+
@@ -0,0 +1,785 @@
+//-----------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+
+//-----------------------------------------------------------------------------------------
+/** \file codectest.cpp
+\n
+  Codec regression tests, run by \c make \c check. The same tests are built twice from \c FIX44.xml in
+  ./schema: \c codectest uses the table driven codec and \c codectest_gen uses the per message decoders
+  and encoders generated by f8c (\c -D \c -E \c ALL). Both must produce the same results. Exits non zero
+  if any check fails.\n
+\n
+<tt>
+	Usage: codectest [-v]\n
+		-v,--verbose            print each check\n
+</tt>
+*/
+
+//-----------------------------------------------------------------------------------------
+#include <iostream>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <list>
+#include <set>
+#include <iterator>
+#include <algorithm>
+#include <bitset>
+
+#include <regex.h>
+#include <errno.h>
+#include <string.h>
+
+// f8 headers
+#include <f8includes.hpp>
+
+#if defined GENERATED_CODEC
+#include "Codecgen_types.hpp"
+#include "Codecgen_router.hpp"
+#include "Codecgen_classes.hpp"
+#else
+#include "Codec_types.hpp"
+#include "Codec_router.hpp"
+#include "Codec_classes.hpp"
+#endif
+
+//-----------------------------------------------------------------------------------------
+using namespace std;
+using namespace FIX8;
+
+//-----------------------------------------------------------------------------------------
+namespace {
+
+unsigned _checks, _failures;
+bool _verbose;
+
+/*! Record the result of a check.
+  \param ok result
+  \param what text of the check
+  \param line source line of the check */
+void check(const bool ok, const char *what, const int line)
+{
+	++_checks;
+	if (!ok)
+	{
+		++_failures;
+		cerr << __FILE__ << ':' << line << ": check failed: " << what << endl;
+	}
+	else if (_verbose)
+		cout << "ok: " << what << endl;
+}
+
+#define CHECK(expr) check((expr), #expr, __LINE__)
+
+/*! Build a complete FIX.4.4 message from its header and body fields, adding BeginString, BodyLength
+    and CheckSum. Fields are separated by '|' in the source for readability.
+  \param fields fields following BodyLength, up to but not including CheckSum
+  \return encoded message */
+f8String make_msg(const f8String& fields)
+{
+	f8String body(fields);
+	replace(body.begin(), body.end(), '|', static_cast<char>(default_field_separator));
+	ostringstream ostr;
+	ostr << "8=FIX.4.4" << default_field_separator << "9=" << body.size() << default_field_separator << body;
+	f8String msg(ostr.str());
+	unsigned sum(0);
+	for (f8String::const_iterator itr(msg.begin()); itr != msg.end(); ++itr)
+		sum += static_cast<unsigned char>(*itr);
+	ostr << "10=" << setfill('0') << setw(3) << sum % 256 << default_field_separator;
+	return ostr.str();
+}
+
+/// A NewOrderSingle with a repeating group, in encode order.
+const f8String nos_fields("35=D|49=CLIENT|56=BROKER|34=7|52=20261016-09:30:00.123|"
+	"11=ORD1|453=2|448=BRKR|447=D|452=1|448=CLNT|447=D|452=3|1=ACC1|55=BHP|54=1|60=20261016-09:30:00.456|"
+	"38=100.00|40=2|44=25.37|59=0|");
+
+//-----------------------------------------------------------------------------------------
+/// Zero copy decode from a buffer that is neither null terminated nor exactly one message long.
+void test_zero_copy_decode()
+{
+	const f8String msg(make_msg(nos_fields));
+	f8String buf(msg);
+	buf += "8=FIX.4.4";		// the next message, partly received
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, buf.data(), msg.size()));
+	CHECK(decoded.get() != 0);
+	CHECK(decoded->get_msgtype() == "D");
+	CHECK(decoded->get<CDC::ClOrdID>() && decoded->get<CDC::ClOrdID>()->get() == "ORD1");
+	CHECK(decoded->get<CDC::OrderQty>() && decoded->get<CDC::OrderQty>()->get() == 100);
+	f8String encoded;
+	decoded->encode(encoded);
+	CHECK(encoded == msg);
+
+	// a buffer that ends before the checksum is rejected without reading outside it
+	bool thrown(false);
+	try { scoped_ptr<Message> cut(Message::factory(CDC::ctx, buf.data(), msg.size() - 4)); } catch (InvalidMessage&) { thrown = true; }
+	CHECK(thrown);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Fields added in any order are encoded, and iterated, in schema position order.
+void test_flat_field_order()
+{
+	CDC::NewOrderSingle nos;
+	*nos.Header() += new CDC::SendingTime(f8String("20261016-09:30:00.123"));
+	*nos.Header() += new CDC::MsgSeqNum(7);
+	*nos.Header() += new CDC::TargetCompID("BROKER");
+	*nos.Header() += new CDC::SenderCompID("CLIENT");
+	nos += new CDC::TimeInForce(CDC::TimeInForce_DAY);
+	nos += new CDC::Price(25.37);
+	nos += new CDC::OrdType(CDC::OrdType_LIMIT);
+	nos += new CDC::OrderQty(100);
+	nos += new CDC::TransactTime(f8String("20261016-09:30:00.456"));
+	nos += new CDC::Side(CDC::Side_BUY);
+	nos += new CDC::Symbol("BHP");
+	nos += new CDC::Account("ACC1");
+	nos += new CDC::NoPartyIDs(2);
+	GroupBase *parties(nos.find_group<CDC::NewOrderSingle::NoPartyIDs>());
+	static const char *ids[] = { "BRKR", "CLNT" };
+	static const int roles[] = { 1, 3 };
+	for (unsigned ii(0); ii < 2; ++ii)
+	{
+		MessageBase *party(parties->create_group());
+		*party += new CDC::PartyRole(roles[ii]);
+		*party += new CDC::PartyIDSource('D');
+		*party += new CDC::PartyID(ids[ii]);
+		*parties += party;
+	}
+	nos += new CDC::ClOrdID("ORD1");
+
+	f8String encoded;
+	nos.encode(encoded);
+	CHECK(encoded == make_msg(nos_fields));
+
+	unsigned last(0), cnt(0);
+	bool ordered(true);
+	for (FieldsIterator itr(nos.fields_begin()); itr != nos.fields_end(); ++itr, ++cnt)
+	{
+		const unsigned pos(nos.getPos(itr->first));
+		ordered &= pos > last && itr->second->get_tag() == itr->first;
+		last = pos;
+	}
+	CHECK(ordered);
+	CHECK(cnt == 10);
+	CHECK(nos.find_field(CDC::Symbol::get_field_id())->first == CDC::Symbol::get_field_id());
+	CHECK(nos.find_field(CDC::StopPx::get_field_id()) == nos.fields_end());
+
+	// a decoded message re-encodes in schema order, not the order its fields arrived in
+	f8String arrival(nos_fields);
+	arrival.erase(arrival.find("44=25.37|59=0|"));
+	arrival.insert(arrival.find("11=ORD1|"), "59=0|44=25.37|");
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, make_msg(arrival)));
+	decoded->encode(encoded);
+	CHECK(encoded == make_msg(nos_fields));
+}
+
+#if defined FIELDPOOLING
+//-----------------------------------------------------------------------------------------
+/// Frees a vector of pool blocks from the calling thread.
+void *free_blocks(void *what)
+{
+	vector<void *>& blocks(*static_cast<vector<void *> *>(what));
+	for (vector<void *>::iterator itr(blocks.begin()); itr != blocks.end(); ++itr)
+		FieldPool::free(*itr, 496);
+	return 0;
+}
+
+/// Allocates and locally frees one block, returning it; the thread then exits leaving its pool to be adopted.
+void *alloc_and_free(void *)
+{
+	void *blk(FieldPool::alloc(480));
+	FieldPool::free(blk, 480);
+	return blk;
+}
+
+/// Allocates up to a bound looking for a given block; everything allocated is freed again.
+void *find_block(void *what)
+{
+	vector<void *> got;
+	void *found(0);
+	for (unsigned ii(0); ii < 1024 && !found; ++ii)
+	{
+		got.push_back(FieldPool::alloc(480));
+		if (got.back() == what)
+			found = what;
+	}
+	for (vector<void *>::iterator itr(got.begin()); itr != got.end(); ++itr)
+		FieldPool::free(*itr, 480);
+	return found;
+}
+
+/// The field pool serves each size class from aligned slabs, takes frees from other threads and reuses the pool of
+/// an exited thread.
+void test_field_pool()
+{
+	bool aligned(true), reused(true);
+	for (size_t sz(1); sz <= FieldPool::granularity * FieldPool::size_classes; sz += FieldPool::granularity / 2)
+	{
+		void *blk(FieldPool::alloc(sz));
+		aligned &= reinterpret_cast<size_t>(blk) % FieldPool::granularity == 0;
+		FieldPool::free(blk, sz);
+		void *again(FieldPool::alloc(sz));
+		reused &= again == blk;	// last freed, first allocated within a class
+		FieldPool::free(again, sz);
+	}
+	CHECK(aligned && reused);
+	void *big(FieldPool::alloc(FieldPool::granularity * FieldPool::size_classes + 1));	// not pooled
+	CHECK(big);
+	FieldPool::free(big, FieldPool::granularity * FieldPool::size_classes + 1);
+
+	// blocks freed by another thread go back to the owner, which reclaims them once its free list is empty
+	vector<void *> blocks;
+	for (unsigned ii(0); ii < 8; ++ii)
+		blocks.push_back(FieldPool::alloc(496));
+	pthread_t thr;
+	pthread_create(&thr, 0, free_blocks, &blocks);
+	pthread_join(thr, 0);
+	const set<void *> freed(blocks.begin(), blocks.end());
+	vector<void *> got;
+	unsigned found(0);
+	while (found < freed.size() && got.size() < 1024)
+	{
+		got.push_back(FieldPool::alloc(496));
+		found += freed.count(got.back());
+	}
+	CHECK(found == freed.size());
+	free_blocks(&got);
+
+	// the pool of an exited thread, with its free lists, is adopted by the next new thread
+	void *orphaned(0), *adopted(0);
+	pthread_create(&thr, 0, alloc_and_free, 0);
+	pthread_join(thr, &orphaned);
+	pthread_create(&thr, 0, find_block, orphaned);
+	pthread_join(thr, &adopted);
+	CHECK(orphaned && adopted == orphaned);
+}
+#endif
+
+//-----------------------------------------------------------------------------------------
+/// A recycled inbound message is reused for the next message of its type and carries nothing over.
+void test_message_recycling()
+{
+	CDC::ctx.set_msg_pool_max(2);
+	Message *first(Message::factory(CDC::ctx, make_msg(nos_fields)));
+	Message::recycle(CDC::ctx, first);
+
+	f8String fields(nos_fields);
+	fields.erase(fields.find("1=ACC1|"), 7);
+	fields.replace(fields.find("11=ORD1"), 7, "11=ORD2");
+	const f8String msg(make_msg(fields));
+	{
+		scoped_msg second(CDC::ctx, Message::factory(CDC::ctx, msg));
+		CHECK(second.get() == first);
+		CHECK(!second->have(CDC::Account::get_field_id()));
+		CHECK(second->find_group<CDC::NewOrderSingle::NoPartyIDs>()->size() == 2);
+		f8String encoded;
+		second->encode(encoded);
+		CHECK(encoded == msg);
+	}
+	CDC::ctx.set_msg_pool_max(0);	// pooled messages are freed with the context
+	scoped_ptr<Message> fresh(Message::factory(CDC::ctx, msg));
+	CHECK(fresh.get() != first);
+}
+
+//-----------------------------------------------------------------------------------------
+/// The vectorised tokenizer agrees with the scalar one, including across refills of its window.
+void test_tokenizer()
+{
+	ostringstream ostr;
+	ostr << "35=D|49=CLIENT|56=BROKER|34=7|52=20261016-09:30:00.123|11=ORD1|453=200|";
+	for (unsigned ii(0); ii < 200; ++ii)	// well over FieldIndex::window elements
+		ostr << "448=P" << ii << "|447=D|452=" << ii % 9 + 1 << '|';
+	ostr << "55=BHP|54=1|60=20261016-09:30:00.456|38=100.00|40=2|44=25.37|59=0|";
+	const f8String msg(make_msg(ostr.str()));
+
+	FieldIndex idx(msg.data(), msg.size());
+	unsigned offset(0), elements(0);
+	bool same(true);
+	for (;;)
+	{
+		unsigned tag(0), vlen(0), stag(0), svlen(0);
+		const char *val(0), *sval(0);
+		const unsigned len(idx.extract(offset, tag, val, vlen)),
+			slen(FieldIndex::extract(msg.data() + offset, msg.size() - offset, stag, sval, svlen));
+		same &= len == slen && (!len || (tag == stag && val == sval && vlen == svlen));
+		if (!len || !same)
+			break;
+		offset += len;
+		++elements;
+	}
+	CHECK(same);
+	CHECK(offset == msg.size());
+	CHECK(elements == 2 + 7 + 600 + 7 + 1);
+	CHECK(elements > static_cast<unsigned>(FieldIndex::window) * 4);
+
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, msg));
+	CHECK(decoded->find_group<CDC::NewOrderSingle::NoPartyIDs>()->size() == 200);
+	f8String encoded;
+	decoded->encode(encoded);
+	CHECK(encoded == msg);
+}
+
+//-----------------------------------------------------------------------------------------
+/// The checksum kernels selected for this cpu agree with a plain byte sum at every length and alignment.
+void test_checksum()
+{
+	char src[512 + 32], dst[512 + 32];
+	for (unsigned ii(0); ii < sizeof(src); ++ii)
+		src[ii] = static_cast<char>(ii * 151 + 7);	// covers bytes with the top bit set
+	bool same(true);
+	for (unsigned align(0); align < 32; align += 5)
+	{
+		for (unsigned len(0); len <= 512; ++len)
+		{
+			unsigned sum(0);
+			for (unsigned ii(0); ii < len; ++ii)
+				sum += static_cast<unsigned char>(src[align + ii]);
+			memset(dst, 0, sizeof(dst));
+			same &= Message::sum_bytes(src + align, len) == sum
+				&& Message::copy_sum_bytes(dst + align, src + align, len) == sum
+				&& memcmp(dst + align, src + align, len) == 0 && !dst[align + len];
+		}
+	}
+	CHECK(same);
+	const f8String msg(make_msg(nos_fields));
+	CHECK(Message::fmt_chksum(Message::calc_chksum(msg, 0, msg.size() - 7)) == msg.substr(msg.size() - 4, 3));
+}
+
+//-----------------------------------------------------------------------------------------
+/// Single pass encode into a caller buffer and into a shared outbound frame, with and without a header block.
+void test_single_pass_encode()
+{
+	const f8String msg(make_msg(nos_fields));
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, msg));
+	char buf[Message::prefix_reserve + MAX_MSG_LENGTH];
+	char *frame;
+	const unsigned len(decoded->encode(buf, frame));
+	CHECK(frame > buf && frame < buf + Message::prefix_reserve);
+	CHECK(f8String(frame, len) == msg);
+
+	// without MSGRECYCLING a message is encoded once, so each encode gets a fresh decode
+	OutboundFrame out;
+	scoped_ptr<Message> shared_src(Message::factory(CDC::ctx, msg));
+	shared_src->encode(out);
+	const OutboundFrame shared(out);
+	CHECK(shared.data() == out.data());
+	CHECK(f8String(out.data(), out.size()) == msg);
+
+	// the header block follows the header fields and is included in BodyLength and CheckSum
+	scoped_ptr<Message> hdr_src(Message::factory(CDC::ctx, msg));
+	delete hdr_src->Header()->remove(CDC::SenderCompID::get_field_id());
+	delete hdr_src->Header()->remove(CDC::TargetCompID::get_field_id());
+	f8String hdrblk("49=CLIENT|56=BROKER|");
+	replace(hdrblk.begin(), hdrblk.end(), '|', static_cast<char>(default_field_separator));
+	const unsigned hlen(hdr_src->encode(buf, frame, hdrblk.data(), hdrblk.size()));
+	CHECK(f8String(frame, hlen) == make_msg("35=D|34=7|52=20261016-09:30:00.123|49=CLIENT|56=BROKER|"
+		+ nos_fields.substr(nos_fields.find("|11=") + 1)));
+}
+
+//-----------------------------------------------------------------------------------------
+/// Fixed point Decimal parse, format, compare and overflow.
+void test_decimal()
+{
+	char buf[24];
+	const char *values[] = { "0", "25.37", "-0.05", "100.00", "0.000000000000000001", "-9223372036854775807" };
+	for (size_t ii(0); ii < sizeof(values) / sizeof(values[0]); ++ii)
+	{
+		const Decimal val(values[ii], ::strlen(values[ii]));
+		CHECK(f8String(buf, val.format(buf)) == values[ii]);
+	}
+
+	const Decimal px("25.37", 5);
+	CHECK(px.mantissa() == 2537 && px.exponent() == 2);
+	CHECK(Decimal("1.5", 3) == Decimal("1.50", 4));
+	CHECK(Decimal("-1.5", 4) < Decimal("-1.49", 5));
+	CHECK(Decimal("92233720368547758.07", 20) < Decimal("92233720368547758.1", 19));	// compare must not rescale
+	CHECK(Decimal::from_double(25.37, 2) == px);
+	CHECK(px.rescale(1) == Decimal(254, 1) && px.rescale(4).mantissa() == 253700);
+
+	// surplus fractional digits round half away from zero, an oversized integer part or rescale throws
+	const Decimal up("0.1234567890123456789", 21), down("-0.12345678901234567849", 23), away("-0.1234567890123456785", 22);
+	CHECK(up.exponent() == Decimal::max_exp && up.mantissa() == 123456789012345679LL);
+	CHECK(down.mantissa() == -123456789012345678LL && away.mantissa() == -123456789012345679LL);
+	CHECK(Decimal("92233720368547758.065", 21) == Decimal("92233720368547758.07", 20));
+	bool thrown(false);
+	try { Decimal("92233720368547758070", 20); } catch (DecimalOverflow&) { thrown = true; }
+	CHECK(thrown);
+	thrown = false;
+	try { Decimal("92233720368547758.075", 21); } catch (DecimalOverflow&) { thrown = true; }	// rounds past the mantissa
+	CHECK(thrown);
+	thrown = false;
+	try { Decimal(Decimal::max_mantissa, 0).rescale(1); } catch (DecimalOverflow&) { thrown = true; }
+	CHECK(thrown);
+
+	// anything other than an optionally signed run of digits with one decimal point is malformed
+	const char *malformed[] = { "12abc", "1.2.3", "", "-", ".", "+-1", "1 " };
+	unsigned rejected(0);
+	for (size_t ii(0); ii < sizeof(malformed) / sizeof(malformed[0]); ++ii)
+		try { Decimal(malformed[ii], ::strlen(malformed[ii])); } catch (BadDecimal&) { ++rejected; }
+	CHECK(rejected == sizeof(malformed) / sizeof(malformed[0]));
+
+	// as a field: a decoded price is re-encoded with the precision it arrived with
+	Field<Decimal, 44> fld("25.370", 6);
+	CHECK(fld.get() == px);
+	size_t sz(0);
+	fld.print(buf, sz);
+	CHECK(f8String(buf, sz) == "25.370");
+}
+
+//-----------------------------------------------------------------------------------------
+/// Timestamp parse and format at each precision, across a day change, and through the timestamp fields.
+void test_timestamps()
+{
+	char buf[40];
+	const char *values[] = { "20261016-09:30:00", "20261016-09:30:00.123", "20261016-09:30:00.123456",
+		"20261016-09:30:00.123456789", "19991231-23:59:59.999", "20261016-09:30:00.007" };
+	const Tickval::ticks secs(1792143000ULL * Tickval::billion);
+	for (size_t ii(0); ii < sizeof(values) / sizeof(values[0]); ++ii)
+	{
+		TimePrecision prec;
+		const Tickval::ticks tv(date_time_parse(values[ii], ::strlen(values[ii]), &prec));
+		CHECK(prec == static_cast<TimePrecision>(::strlen(values[ii]) > 17 ? ::strlen(values[ii]) - 18 : 0));
+		CHECK(f8String(buf, date_time_format(tv, buf, prec)) == values[ii]);	// alternates days in the cached prefix
+	}
+	CHECK(date_time_parse(values[0], 17) == secs);
+	CHECK(date_time_parse(values[3], 27) == secs + 123456789);
+	CHECK(f8String(buf, date_time_format(secs + 123456789, buf, tp_milliseconds)) == values[1]);	// truncated, not rounded
+
+	// fields keep the precision they were decoded with
+	const Field<UTCTimestamp, 60> ts(values[2], ::strlen(values[2]));
+	CHECK(ts.get().get_ticks() == secs + 123456000);
+	size_t sz(0);
+	ts.print(buf, sz);
+	CHECK(f8String(buf, sz) == values[2]);
+
+	const f8String tz("20261016-19:30:00.123+10:00");
+	const Field<TZTimestamp, 60> tzts(tz);
+	CHECK(tzts.get().get_ticks() == secs + 123000000 && tzts.get_tzdiff() == 600);
+	sz = 0;
+	tzts.print(buf, sz);
+	CHECK(f8String(buf, sz) == tz);
+
+	// bad separators, digits, ranges or trailing characters give no time at all
+	const char *bad[] = { "20261316-09:30:00", "20260230-09:30:00", "20250229-09:30:00", "20261016 09:30:00",
+		"20261016-09.30:00", "2026101a-09:30:00", "20261016-24:00:00", "20261016-09:60:00", "20261016-09:30:61",
+		"20261016-09:30:00.", "20261016-09:30:00x", "20261016-09:30:00.12x", "20261016-09:30" };
+	unsigned rejected(0);
+	for (size_t ii(0); ii < sizeof(bad) / sizeof(bad[0]); ++ii)
+		rejected += date_time_parse(bad[ii], ::strlen(bad[ii])) == Tickval::noticks;
+	CHECK(rejected == sizeof(bad) / sizeof(bad[0]));
+	CHECK(date_time_parse("20240229-23:59:60", 17) != Tickval::noticks);	// leap day and leap second
+	CHECK(time_parse("09:30", 5) == 34200ULL * Tickval::billion && time_parse("09:30:00.5", 10) == 34200500000000ULL);
+	CHECK(time_parse("24:00", 5) == Tickval::noticks && time_parse("09:3a", 5) == Tickval::noticks
+		&& time_parse("09:30:00x", 9) == Tickval::noticks);
+	CHECK(date_parse("20261016", 8) == 20742ULL * 86400 * Tickval::billion);
+	CHECK(date_parse("20261032", 8) == Tickval::noticks && date_parse("2026101", 7) == Tickval::noticks
+		&& date_parse("20261016x", 9) == Tickval::noticks);
+	typedef Field<TZTimestamp, 60> TZTS;
+	typedef Field<TZTimeOnly, 1079> TZTO;
+	CHECK(!TZTS(f8String("20261016-19:30:00.123+1x")).get()
+		&& !TZTS(f8String("20261316-19:30:00Z")).get()
+		&& !!TZTS(f8String("20261016-19:30:00Z")).get());
+	CHECK(!TZTO(f8String("19:30:00+25")).get() && !TZTO(f8String("19:3:00Z")).get()
+		&& TZTO(f8String("19:30:00-05:30")).get_tzdiff() == -330);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Lazy decode retains the message, constructs fields on access and copies untouched fields through on encode.
+void test_lazy_decode()
+{
+	const f8String msg(make_msg(nos_fields));
+	CDC::ctx.set_flag(F8MetaCntx::lazydecode);
+	f8String buf(msg);
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, buf));
+	buf.assign(buf.size(), '#');	// fields must come from the retained copy
+	f8String encoded;
+	decoded->encode(encoded);
+	CHECK(encoded == msg);
+
+	scoped_ptr<Message> accessed(Message::factory(CDC::ctx, msg));
+	CHECK(accessed->get<CDC::Price>() && accessed->get<CDC::Price>()->get() == 25.37);
+	GroupBase *parties(accessed->find_group<CDC::NewOrderSingle::NoPartyIDs>());
+	CHECK(parties && parties->size() == 2);
+	const MessageBase *party(parties->get_element(1));
+	CHECK(party->get<CDC::PartyID>() && party->get<CDC::PartyID>()->get() == "CLNT");
+	*accessed += new CDC::ClOrdID("ORD2");	// replaces a field that was never constructed
+	accessed->encode(encoded);
+	f8String changed(nos_fields);
+	changed.replace(changed.find("11=ORD1"), 7, "11=ORD2");
+	CHECK(encoded == make_msg(changed));
+
+	// an element longer than 65535 bytes keeps its full extent until constructed
+	const f8String text(70000, 'T');
+	scoped_ptr<Message> large(Message::factory(CDC::ctx, make_msg(nos_fields + "58=" + text + "|")));
+	CHECK(large->get<CDC::Text>() && large->get<CDC::Text>()->get() == text);
+	CDC::ctx.clear_flag(F8MetaCntx::lazydecode);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Reads get() on a shared string field; used to race first calls.
+void *read_string(void *what)
+{
+	return const_cast<f8String *>(&static_cast<const Field<f8String, 58> *>(what)->get());
+}
+
+/// String values are held inline or in an overflow block and read in place; the f8String copy is shared by readers.
+void test_string_storage()
+{
+	typedef Field<f8String, 58> Text;
+	const f8String shorter("short text"), longer(100, 'L');
+	Text inl(shorter), ovf(longer);
+	CHECK(f8String(inl.data(), inl.size()) == shorter && f8String(ovf.data(), ovf.size()) == longer);
+	const char *const ibase(reinterpret_cast<const char *>(&inl)), *const obase(reinterpret_cast<const char *>(&ovf));
+	CHECK(inl.data() >= ibase && inl.data() < ibase + sizeof(inl));	// held in the field
+	CHECK(ovf.data() < obase || ovf.data() >= obase + sizeof(ovf));
+	Text copy(ovf);
+	CHECK(copy.data() != ovf.data() && copy.get() == longer);
+	copy = inl;
+	CHECK(copy.get() == shorter && copy.size() == shorter.size());
+	copy.set(longer);
+	CHECK(copy.get() == longer);	// an existing copy follows the new value
+
+	const CDC::SenderCompID sender("CLIENT");
+	const CDC::TargetCompID target("CLIENT");
+	CHECK(sender.interned() && sender.same(target) && &sender.get() == sender.interned());
+
+	// f8c selects the other interned fields: the defaults, or those named with -I
+	CHECK(CDC::Currency("AUD").interned() && !CDC::Account("ACC1").interned());
+#if defined GENERATED_CODEC
+	CHECK(CDC::Symbol("BHP").interned() && !CDC::SenderSubID("DESK").interned());	// -I Currency,Symbol
+#else
+	CHECK(!CDC::Symbol("BHP").interned() && CDC::SenderSubID("DESK").interned());
+#endif
+
+	// lookups compare in place; past the per thread cache each value still maps to one entry
+	vector<const f8String *> first;
+	bool stable(true);
+	for (unsigned pass(0); pass < 2; ++pass)
+	{
+		for (unsigned ii(0); ii < 4 * StringIntern::cache_size; ++ii)
+		{
+			ostringstream ostr;
+			ostr << "VAL" << ii;
+			const f8String *val(StringIntern::intern(ostr.str()));
+			stable &= val && *val == ostr.str();
+			if (pass)
+				stable &= val == first[ii];
+			else
+				first.push_back(val);
+		}
+	}
+	CHECK(stable);
+	CHECK(!StringIntern::intern(f8String(StringIntern::max_length + 1, 'X')));
+
+	pthread_t readers[4];
+	void *seen[4];
+	for (unsigned ii(0); ii < 4; ++ii)
+		pthread_create(&readers[ii], 0, read_string, &ovf);
+	bool shared(true);
+	for (unsigned ii(0); ii < 4; ++ii)
+	{
+		pthread_join(readers[ii], &seen[ii]);
+		shared &= seen[ii] == seen[0];
+	}
+	CHECK(shared && static_cast<f8String *>(seen[0]) == &ovf.get() && ovf.get() == longer);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Message type and field tag lookups find every generated entry and reject anything else.
+void test_meta_lookup()
+{
+	bool found(true);
+	for (const MsgTable::Pair *itr(CDC::ctx._bme.begin()); itr != CDC::ctx._bme.end(); ++itr)
+		found &= CDC::ctx.find_msg(itr->_key) == itr;
+	CHECK(found);
+	CHECK(!CDC::ctx.find_msg("ZZ") && !CDC::ctx.find_msg("") && !CDC::ctx.find_msg("DD") && !CDC::ctx.find_msg("AAAAAA"));
+	CHECK(CDC::ctx.find_msg("D", 1) == CDC::ctx.find_msg("DX", 1));
+
+	found = true;
+	for (const FieldTable::Pair *itr(CDC::ctx._be.begin()); itr != CDC::ctx._be.end(); ++itr)
+		found &= CDC::ctx.find_be(itr->_key) == &itr->_value;
+	CHECK(found);
+	CHECK(!CDC::ctx.find_be(0) && !CDC::ctx.find_be(9999) && !CDC::ctx.find_be(65535));
+}
+
+//-----------------------------------------------------------------------------------------
+/// Records the events presented by the streaming decoder, fields as "tag=value|" and groups in brackets.
+class TraceVisitor : public MessageVisitor
+{
+	bool _wanted;
+
+public:
+	ostringstream _trace;
+	unsigned _fields;
+
+	TraceVisitor(const bool wanted=true) : _wanted(wanted), _fields() {}
+
+	bool on_message_begin(const f8String& mtype, const BaseMsgEntry& bme)
+	{
+		_trace << '<' << mtype << '>';
+		return _wanted;
+	}
+	void on_field(const unsigned short tag, const FieldValue& value) { ++_fields; _trace << tag << '=' << value << '|'; }
+	void on_group_begin(const unsigned short tag, const unsigned count) { _trace << '[' << count; }
+	void on_group_instance(const unsigned short tag, const unsigned inst) { _trace << '#' << inst; }
+	void on_group_end(const unsigned short tag) { _trace << ']'; }
+	void on_message_end() { _trace << "<end>"; }
+};
+
+/// The streaming decoder presents every field in wire order, with group structure, without building a message.
+void test_visitor()
+{
+	const f8String msg(make_msg(nos_fields));
+	TraceVisitor vis;
+	CHECK(Message::decode(CDC::ctx, msg.data(), msg.size(), vis) == msg.size());
+	f8String expected(msg);
+	replace(expected.begin(), expected.end(), static_cast<char>(default_field_separator), '|');
+	expected.replace(expected.find("448="), 0, "[2#0");
+	expected.replace(expected.find("448=CLNT"), 0, "#1");
+	expected.replace(expected.find("1=ACC1"), 0, "]");
+	CHECK(vis._trace.str() == "<D>" + expected + "<end>");
+	CHECK(vis._fields == 24);
+
+	TraceVisitor skip(false);
+	CHECK(Message::decode(CDC::ctx, msg.data(), msg.size(), skip) == msg.size());
+	CHECK(skip._trace.str() == "<D>" && !skip._fields);
+
+	f8String bad(msg);
+	bad[bad.size() - 2] = bad[bad.size() - 2] == '0' ? '1' : '0';
+	bool thrown(false);
+	try { Message::decode(CDC::ctx, bad.data(), bad.size(), skip); } catch (BadCheckSum&) { thrown = true; }
+	CHECK(thrown);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Selective decode constructs only the wanted body fields and group counts, and keeps decoding past a skipped group.
+void test_selective_decode()
+{
+	const f8String msg(make_msg(nos_fields));
+	FieldInterest interest(CDC::ctx);
+	const unsigned short wanted[] = { CDC::Symbol::get_field_id(), CDC::Price::get_field_id() };
+	interest.add("D", wanted, wanted + sizeof(wanted) / sizeof(wanted[0]));
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, msg, &interest));
+	CHECK(decoded->get<CDC::Symbol>() && decoded->get<CDC::Symbol>()->get() == "BHP");
+	CHECK(decoded->get<CDC::Price>() && decoded->get<CDC::Price>()->get() == 25.37);	// after the group
+	CHECK(!decoded->have(CDC::ClOrdID::get_field_id()) && !decoded->have(CDC::TimeInForce::get_field_id()));
+	CHECK(decoded->have(CDC::NoPartyIDs::get_field_id()));
+	unsigned cnt(0);
+	for (FieldsIterator itr(decoded->fields_begin()); itr != decoded->fields_end(); ++itr)
+		++cnt;
+	CHECK(cnt == 3);
+	CHECK(decoded->Header()->have(CDC::SenderCompID::get_field_id()));
+
+	// other message types are decoded in full
+	scoped_ptr<Message> full(Message::factory(CDC::ctx, make_msg("35=0|49=BROKER|56=CLIENT|34=8|52=20261016-09:30:01.000|112=T1|"),
+		&interest));
+	CHECK(full->have(CDC::TestReqID::get_field_id()));
+}
+
+//-----------------------------------------------------------------------------------------
+/// Messages share their generated trait table but keep presence and suppression per instance.
+void test_instance_presence()
+{
+	CDC::NewOrderSingle filled, empty;
+	filled += new CDC::ClOrdID("ORD1");
+	filled += new CDC::Symbol("BHP");
+	CHECK(filled.have(CDC::ClOrdID::get_field_id()) && !empty.have(CDC::ClOrdID::get_field_id()));
+	CHECK(empty.get_fp().find_missing() == CDC::ClOrdID::get_field_id());
+	const unsigned short missing(filled.get_fp().find_missing());
+	CHECK(missing && missing != CDC::ClOrdID::get_field_id() && missing != CDC::Symbol::get_field_id());
+	CHECK(filled.get_fp().get_presence().begin() == empty.get_fp().get_presence().begin());
+
+	scoped_ptr<Message> decoded(Message::factory(CDC::ctx, make_msg(nos_fields)));
+	const GroupBase *parties(decoded->find_group<CDC::NewOrderSingle::NoPartyIDs>());
+	MessageBase *first(parties->get_element(0));
+	delete first->remove(CDC::PartyRole::get_field_id());
+	CHECK(!first->have(CDC::PartyRole::get_field_id()) && parties->get_element(1)->have(CDC::PartyRole::get_field_id()));
+
+	// a copy starts with the same flags; changing either leaves the other, and the shared table, alone
+	FieldTraits copy(filled.get_fp());
+	copy.set(CDC::Symbol::get_field_id(), FieldTrait::suppress);
+	copy.clear(CDC::ClOrdID::get_field_id());
+	CHECK(copy.get(CDC::Symbol::get_field_id(), FieldTrait::suppress) && !copy.is_present(CDC::ClOrdID::get_field_id()));
+	CHECK(!filled.get_fp().get(CDC::Symbol::get_field_id(), FieldTrait::suppress) && filled.have(CDC::ClOrdID::get_field_id()));
+	CHECK(!empty.get_fp().get(CDC::Symbol::get_field_id(), FieldTrait::suppress));
+
+	// adding a trait takes a private copy of the table
+	const size_t traits(copy.size());
+	CHECK(copy.add(FieldTrait(9999, FieldTrait::ft_string)));
+	CHECK(copy.size() == traits + 1 && filled.get_fp().size() == traits && !filled.get_fp().has(9999));
+	CHECK(copy.is_present(CDC::Symbol::get_field_id()) && copy.get(CDC::Symbol::get_field_id(), FieldTrait::suppress));
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	_verbose = argc > 1 && (strcmp(argv[1], "-v") == 0 || strcmp(argv[1], "--verbose") == 0);
+
+	try
+	{
+		test_zero_copy_decode();
+		test_flat_field_order();
+#if defined FIELDPOOLING
+		test_field_pool();
+#endif
+		test_message_recycling();
+		test_tokenizer();
+		test_checksum();
+		test_single_pass_encode();
+		test_decimal();
+		test_timestamps();
+		test_lazy_decode();
+		test_string_storage();
+		test_meta_lookup();
+		test_visitor();
+		test_selective_decode();
+		test_instance_presence();
+	}
+	catch (f8Exception& e)
+	{
+		++_failures;
+		cerr << "exception: " << e.what() << endl;
+	}
+
+	cout << _checks << " checks, " << _failures << " failed" << endl;
+	return _failures ? 1 : 0;
+}
+
@@ -0,0 +1,965 @@
+//-----------------------------------------------------------------------------------------
+#if 0
+
+Fix8 is released under the GNU LESSER GENERAL PUBLIC LICENSE Version 3.
+
+Fix8 Open Source FIX Engine.
+Copyright (C) 2010-13 David L. Dight <fix@fix8.org>
+
+Fix8 is free software: you can  redistribute it and / or modify  it under the  terms of the
+GNU Lesser General  Public License as  published  by the Free  Software Foundation,  either
+version 3 of the License, or (at your option) any later version.
+
+Fix8 is distributed in the hope  that it will be useful, but WITHOUT ANY WARRANTY;  without
+even the  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+You should  have received a copy of the GNU Lesser General Public  License along with Fix8.
+If not, see <http://www.gnu.org/licenses/>.
+
+BECAUSE THE PROGRAM IS  LICENSED FREE OF  CHARGE, THERE IS NO  WARRANTY FOR THE PROGRAM, TO
+THE EXTENT  PERMITTED  BY  APPLICABLE  LAW.  EXCEPT WHEN  OTHERWISE  STATED IN  WRITING THE
+COPYRIGHT HOLDERS AND/OR OTHER PARTIES  PROVIDE THE PROGRAM "AS IS" WITHOUT WARRANTY OF ANY
+KIND,  EITHER EXPRESSED   OR   IMPLIED,  INCLUDING,  BUT   NOT  LIMITED   TO,  THE  IMPLIED
+WARRANTIES  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU. SHOULD THE PROGRAM PROVE DEFECTIVE,
+YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRECTION.
+
+IN NO EVENT UNLESS REQUIRED  BY APPLICABLE LAW  OR AGREED TO IN  WRITING WILL ANY COPYRIGHT
+HOLDER, OR  ANY OTHER PARTY  WHO MAY MODIFY  AND/OR REDISTRIBUTE  THE PROGRAM AS  PERMITTED
+ABOVE,  BE  LIABLE  TO  YOU  FOR  DAMAGES,  INCLUDING  ANY  GENERAL, SPECIAL, INCIDENTAL OR
+CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE THE PROGRAM (INCLUDING BUT
+NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR
+THIRD PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH
+HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#endif
+
+//-----------------------------------------------------------------------------------------
+/** \file runtimetest.cpp
+\n
+  Runtime regression tests, run by \c make \c check. Covers the threading and socket layers that the codec
+  tests do not: thread placement policies, wait strategies, the reader and writer over connected socket pairs,
+  and the reactor. Exits non zero if any check fails.\n
+\n
+<tt>
+	Usage: runtimetest [-v]\n
+		-v,--verbose            print each check\n
+</tt>
+*/
+
+//-----------------------------------------------------------------------------------------
+#include <iostream>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <list>
+#include <set>
+#include <iterator>
+#include <algorithm>
+#include <bitset>
+
+#include <regex.h>
+#include <errno.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+
+// f8 headers
+#include <f8includes.hpp>
+#include <Poco/Net/StreamSocketImpl.h>
+
+#include "Codec_types.hpp"
+#include "Codec_router.hpp"
+#include "Codec_classes.hpp"
+
+//-----------------------------------------------------------------------------------------
+using namespace std;
+using namespace FIX8;
+
+//-----------------------------------------------------------------------------------------
+namespace {
+
+unsigned _checks, _failures;
+bool _verbose;
+
+/*! Record the result of a check.
+  \param ok result
+  \param what text of the check
+  \param line source line of the check */
+void check(const bool ok, const char *what, const int line)
+{
+	++_checks;
+	if (!ok)
+	{
+		++_failures;
+		cerr << __FILE__ << ':' << line << ": check failed: " << what << endl;
+	}
+	else if (_verbose)
+		cout << "ok: " << what << endl;
+}
+
+#define CHECK(expr) check((expr), #expr, __LINE__)
+
+typedef vector<unsigned> Cpus;
+
+/*! Parse a cpu list, leaving the target untouched on failure.
+  \param from cpu list
+  \param to target, preset to a marker so a failed parse can be told from an empty one
+  \return true on success */
+bool parse(const f8String& from, Cpus& to)
+{
+	to.assign(1, 999);
+	return ThreadPolicy::parse_cpus(from, to);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Cpu lists from configuration and sysfs are parsed strictly; a rejected list leaves the target unchanged.
+void test_parse_cpus()
+{
+	Cpus cpus;
+	CHECK(parse("0-3,8", cpus));
+	CHECK(cpus.size() == 5 && cpus[0] == 0 && cpus[3] == 3 && cpus[4] == 8);
+	CHECK(parse("0-3,8\n", cpus));	// as read from /sys/devices/system/node/nodeN/cpulist
+	CHECK(cpus.size() == 5 && cpus[4] == 8);
+	CHECK(parse("5", cpus) && cpus.size() == 1 && cpus[0] == 5);
+	CHECK(parse("1, 2 ,3", cpus) && cpus.size() == 3 && cpus[2] == 3);
+
+	// empty and blank lists clear the restriction
+	CHECK(parse("", cpus) && cpus.empty());
+	CHECK(parse("\n", cpus) && cpus.empty());
+
+	// reversed ranges, out of range cpus and stray characters are rejected
+	CHECK(!parse("3-1", cpus) && cpus.size() == 1 && cpus[0] == 999);
+	ostringstream max, range;
+	max << ThreadPolicy::max_cpus;
+	range << "0-" << ThreadPolicy::max_cpus;
+	CHECK(!parse(max.str(), cpus));
+	CHECK(!parse(range.str(), cpus));
+	CHECK(!parse("-1", cpus));
+	CHECK(!parse("0-", cpus));
+	CHECK(!parse("1,,2", cpus));
+	CHECK(!parse("0-3x", cpus));
+	CHECK(!parse("a", cpus));
+	CHECK(!parse("0;1", cpus));
+	CHECK(cpus.size() == 1 && cpus[0] == 999);
+
+	ThreadPolicy policy;
+	CHECK(policy.set_cpus("1-2") && policy.get_cpus().size() == 2);
+	CHECK(!policy.set_cpus("2-1") && policy.get_cpus().size() == 2);
+}
+
+#if defined __linux__
+/// Records where a thread ran.
+struct Placed
+{
+	int _cpu;
+	cpu_set_t _set;
+
+	Placed() : _cpu(-1) { CPU_ZERO(&_set); }
+
+	int operator()()
+	{
+		_cpu = sched_getcpu();
+		return sched_getaffinity(0, sizeof(_set), &_set);
+	}
+};
+
+//-----------------------------------------------------------------------------------------
+/// A thread started with a single cpu policy is placed on that cpu and reports no policy error.
+void test_thread_affinity()
+{
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+	int cpu(0);
+	while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))	// the first cpu this process may use
+		++cpu;
+	CHECK(cpu < CPU_SETSIZE);
+
+	ostringstream ostr;
+	ostr << cpu;
+	ThreadPolicy policy;
+	CHECK(policy.set_cpus(ostr.str()));
+
+	Placed placed;
+	dthread<Placed> thread(ref(placed));
+	thread.set_policy(policy);
+	CHECK(thread.start() == 0);
+	CHECK(thread.join() == 0);
+	CHECK(thread.get_policy_error() == 0);
+	CHECK(placed._cpu == cpu);
+	CHECK(CPU_COUNT(&placed._set) == 1 && CPU_ISSET(cpu, &placed._set));
+}
+#endif
+
+//-----------------------------------------------------------------------------------------
+typedef f8_concurrent_queue<int *> IntQueue;
+
+/// Queue consumer, as run by the reader callback and writer threads.
+struct Consumer
+{
+	IntQueue& _queue;
+	WaitStrategy _wait;
+	const int *_stop;
+	vector<int> _seen;
+	Tickval _stopped;
+
+	Consumer(IntQueue& queue, const WaitStrategy& wait, const int *stop) : _queue(queue), _wait(wait), _stop(stop) {}
+
+	int operator()()
+	{
+		for (;;)
+		{
+			int *item(0);
+			if (!_wait.pop(_queue, item))
+				continue;
+			if (item == _stop)
+			{
+				_stopped.now();
+				break;
+			}
+			_seen.push_back(*item);
+		}
+		return 0;
+	}
+};
+
+/// Queue producer. Pauses now and then so that the consumer runs dry and has to wait.
+struct Producer
+{
+	IntQueue& _queue;
+	WaitStrategy& _wait;
+	vector<int>& _items;
+	size_t _from, _to;
+
+	Producer(IntQueue& queue, WaitStrategy& wait, vector<int>& items, const size_t from, const size_t to)
+		: _queue(queue), _wait(wait), _items(items), _from(from), _to(to) {}
+
+	int operator()()
+	{
+		for (size_t ii(_from); ii < _to; ++ii)
+		{
+			_queue.push(&_items[ii]);
+			_wait.notify();
+			if (ii % 1000 == 999)
+				hypersleep<h_microseconds>(500);
+		}
+		return 0;
+	}
+};
+
+//-----------------------------------------------------------------------------------------
+/// With every wait strategy, two producers feeding one consumer lose nothing, each producer's items arrive in
+/// order, and a stop pushed to an idle consumer is seen well within the longest park.
+void test_wait_strategies()
+{
+	const unsigned count(20000);
+	vector<int> items(count);
+	for (unsigned ii(0); ii < count; ++ii)
+		items[ii] = ii;
+	int stop(-1);
+
+	for (int ws(0); ws < WaitStrategy::ws_count; ++ws)
+	{
+		IntQueue queue;
+		Consumer consumer(queue, WaitStrategy(static_cast<WaitStrategy::Strategy>(ws)), &stop);
+		dthread<Consumer> cthread(ref(consumer));
+		CHECK(cthread.start() == 0);
+
+		Producer first(queue, consumer._wait, items, 0, count / 2), second(queue, consumer._wait, items, count / 2, count);
+		dthread<Producer> pthread1(ref(first)), pthread2(ref(second));
+		CHECK(pthread1.start() == 0 && pthread2.start() == 0);
+		pthread1.join();
+		pthread2.join();
+
+		hypersleep<h_milliseconds>(20);	// let the consumer drain the queue and go idle
+		const Tickval stopping(true);
+		queue.push(&stop);
+		consumer._wait.notify();
+		cthread.join();
+
+		const vector<int>& seen(consumer._seen);
+		vector<bool> found(count);
+		int last1(-1), last2(count / 2 - 1);
+		bool ordered(true), unique(true);
+		for (vector<int>::const_iterator itr(seen.begin()); itr != seen.end(); ++itr)
+		{
+			int& last(*itr < static_cast<int>(count / 2) ? last1 : last2);
+			ordered &= *itr > last;
+			last = *itr;
+			unique &= !found[*itr];
+			found[*itr] = true;
+		}
+		const Tickval::ticks waited((consumer._stopped - stopping).get_ticks() / Tickval::thousand);
+		if (_verbose)
+			cout << "strategy " << ws << ": " << seen.size() << " consumed, stop seen after " << waited << "us" << endl;
+		CHECK(seen.size() == count);
+		CHECK(unique);
+		CHECK(ordered);
+		CHECK(waited < WaitStrategy::block_park_us / 2);	// woken by the notify, not by the park timeout
+	}
+}
+
+//-----------------------------------------------------------------------------------------
+/*! Build a complete FIX.4.4 message from its header and body fields, adding BeginString, BodyLength
+    and CheckSum. Fields are separated by '|' in the source for readability.
+  \param fields fields following BodyLength, up to but not including CheckSum
+  \return encoded message */
+f8String make_msg(const f8String& fields)
+{
+	f8String body(fields);
+	replace(body.begin(), body.end(), '|', static_cast<char>(default_field_separator));
+	ostringstream ostr;
+	ostr << "8=FIX.4.4" << default_field_separator << "9=" << body.size() << default_field_separator << body;
+	f8String msg(ostr.str());
+	unsigned sum(0);
+	for (f8String::const_iterator itr(msg.begin()); itr != msg.end(); ++itr)
+		sum += static_cast<unsigned char>(*itr);
+	ostr << "10=" << setfill('0') << setw(3) << sum % 256 << default_field_separator;
+	return ostr.str();
+}
+
+/*! Build a News message carrying a headline of a given length.
+  \param id message sequence number, to tell messages apart
+  \param len headline length
+  \return encoded message */
+f8String make_news(const unsigned id, const size_t len)
+{
+	ostringstream ostr;
+	ostr << "35=B|49=SRV|56=CLT|34=" << id << "|52=20261017-10:00:00.000|148=" << f8String(len, 'a' + id % 26) << '|';
+	return make_msg(ostr.str());
+}
+
+/// A connected pair of stream sockets. The near end is wrapped for the reader or writer under test; the test
+/// drives the far end directly.
+struct SocketPair
+{
+	int _fds[2];
+	Poco::Net::StreamSocket *_sock;
+
+	SocketPair() : _sock()
+	{
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, _fds) == 0)
+			_sock = new Poco::Net::StreamSocket(new Poco::Net::StreamSocketImpl(_fds[0]));
+		else
+			_fds[0] = _fds[1] = -1;
+	}
+
+	~SocketPair()
+	{
+		delete _sock;	// closes the near end
+		close_far();
+	}
+
+	/*! Write to the far end.
+	  \param what bytes to write
+	  \return true if all were written */
+	bool put(const f8String& what) { return ::write(_fds[1], what.data(), what.size()) == static_cast<ssize_t>(what.size()); }
+
+	/*! Read from the far end.
+	  \param len number of bytes to read
+	  \return what was read, short only if the near end was closed */
+	f8String get(const size_t len)
+	{
+		f8String result;
+		char buf[4096];
+		while (result.size() < len)
+		{
+			const ssize_t got(::read(_fds[1], buf, min(sizeof(buf), len - result.size())));
+			if (got <= 0)
+				break;
+			result.append(buf, got);
+		}
+		return result;
+	}
+
+	/*! Check there is nothing more to read at the far end.
+	  \return true if nothing is waiting, or the near end has shut down */
+	bool drained()
+	{
+		char ch;
+		const ssize_t got(::recv(_fds[1], &ch, 1, MSG_DONTWAIT));
+		return got == 0 || (got < 0 && errno == EAGAIN);
+	}
+
+	/// Close the far end.
+	void close_far()
+	{
+		if (_fds[1] >= 0)
+			::close(_fds[1]);
+		_fds[1] = -1;
+	}
+};
+
+/// Session that records the messages handed to it instead of processing them.
+struct Recorder : public Session
+{
+	vector<f8String> _received;
+
+	Recorder() : Session(CDC::ctx) {}
+
+	bool process(const f8String& from)
+	{
+		_received.push_back(from);
+		return true;
+	}
+};
+
+/// Unpipelined reader with its framing exposed.
+struct TestReader : public FIXReader
+{
+	TestReader(Poco::Net::StreamSocket *sock, Session& session) : FIXReader(sock, session, false) {}
+
+	using FIXReader::fill;
+	using FIXReader::frame;
+
+	/*! Frame the next message, recording the type of any framing error.
+	  \param to string to place message in
+	  \param error set to the name of the exception thrown, if any
+	  \return true if a complete message was available */
+	bool try_frame(f8String& to, f8String& error)
+	{
+		error.clear();
+		try
+		{
+			return frame(to);
+		}
+		catch (InvalidVersion&) { error = "InvalidVersion"; }
+		catch (InvalidBodyLength&) { error = "InvalidBodyLength"; }
+		catch (IllegalMessage&) { error = "IllegalMessage"; }
+		return false;
+	}
+};
+
+//-----------------------------------------------------------------------------------------
+/// Messages are framed however the stream splits them: across reads, several to a read, and with BodyLength
+/// itself split between reads.
+void test_reader_framing()
+{
+	SocketPair pair;
+	CHECK(pair._sock != 0);
+	Recorder session;
+	TestReader reader(pair._sock, session);
+	f8String out, error;
+
+	// one message in three pieces
+	const f8String msg(make_news(1, 40));
+	CHECK(pair.put(msg.substr(0, 5)) && reader.fill() == 5);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg.substr(5, 30)) && reader.fill() == 30);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg.substr(35)) && reader.fill() == msg.size() - 35);
+	CHECK(reader.try_frame(out, error) && out == msg);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+
+	// three messages in one read, the last followed by the start of a fourth
+	const f8String msg2(make_news(2, 10)), msg3(make_news(3, 200)), msg4(make_news(4, 20));
+	CHECK(pair.put(msg + msg2 + msg3 + msg4.substr(0, 12)));
+	CHECK(reader.fill() == msg.size() + msg2.size() + msg3.size() + 12);
+	CHECK(reader.try_frame(out, error) && out == msg);
+	CHECK(reader.try_frame(out, error) && out == msg2);
+	CHECK(reader.try_frame(out, error) && out == msg3);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg4.substr(12)) && reader.fill() == msg4.size() - 12);
+	CHECK(reader.try_frame(out, error) && out == msg4);
+
+	// BodyLength split mid digits, then its separator arriving on its own
+	CHECK(msg3.compare(0, 13, "8=FIX.4.4\0019=2") == 0 && msg3[15] == default_field_separator);
+	CHECK(pair.put(msg3.substr(0, 13)) && reader.fill() == 13);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg3.substr(13, 2)) && reader.fill() == 2);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg3.substr(15, 1)) && reader.fill() == 1);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+	CHECK(pair.put(msg3.substr(16)) && reader.fill() == msg3.size() - 16);
+	CHECK(reader.try_frame(out, error) && out == msg3);
+}
+
+//-----------------------------------------------------------------------------------------
+/// A malformed preamble or BodyLength is rejected and the receive buffer discarded; the next message read is
+/// framed normally.
+void test_reader_errors()
+{
+	SocketPair pair;
+	Recorder session;
+	TestReader reader(pair._sock, session);
+	f8String out, error;
+	const f8String good(make_news(1, 30));
+
+	f8String bad(good);
+	bad[8] = '2';	// FIX.4.2
+	CHECK(pair.put(bad + good) && reader.fill() == bad.size() + good.size());
+	CHECK(!reader.try_frame(out, error) && error == "InvalidVersion");
+	CHECK(!reader.try_frame(out, error) && error.empty());	// the good message went with the bad
+	CHECK(pair.put(good) && reader.fill() == good.size());
+	CHECK(reader.try_frame(out, error) && out == good);
+
+	CHECK(pair.put("X=FIX.4.4\0019=5\001") && reader.fill());
+	CHECK(!reader.try_frame(out, error) && error == "IllegalMessage");
+
+	// longer than any message we accept
+	CHECK(pair.put("8=FIX.4.4\0019=9000\00135=B\001") && reader.fill());
+	CHECK(!reader.try_frame(out, error) && error == "InvalidBodyLength");
+	CHECK(pair.put("8=FIX.4.4\0019=0\00135=B\001") && reader.fill());
+	CHECK(!reader.try_frame(out, error) && error == "InvalidBodyLength");
+
+	// too many digits is rejected before the separator arrives
+	CHECK(pair.put("8=FIX.4.4\0019=0000000001") && reader.fill());
+	CHECK(!reader.try_frame(out, error) && error == "IllegalMessage");
+	CHECK(pair.put("8=FIX.4.4\0019=\00135=B\001") && reader.fill());
+	CHECK(!reader.try_frame(out, error) && error == "IllegalMessage");
+
+	CHECK(pair.put(good) && reader.fill() == good.size());
+	CHECK(reader.try_frame(out, error) && out == good);
+}
+
+//-----------------------------------------------------------------------------------------
+/// A partial message near the end of the receive buffer is moved down so that the rest of it fits.
+void test_reader_compaction()
+{
+	SocketPair pair;
+	Recorder session;
+	TestReader reader(pair._sock, session);
+	f8String out, error, burst;
+
+	// fill all but the last few kB of the receive buffer, ending with the start of a message too big for what is left
+	vector<f8String> sent;
+	while (burst.size() < 8 * MAX_MSG_LENGTH - MAX_MSG_LENGTH / 2)
+	{
+		sent.push_back(make_news(sent.size(), 1500));
+		burst += sent.back();
+	}
+	const f8String big(make_news(99, MAX_MSG_LENGTH - 200));
+	CHECK(big.size() < MAX_MSG_LENGTH && big.size() > MAX_MSG_LENGTH / 2 + 100);
+	CHECK(pair.put(burst + big.substr(0, 100)) && reader.fill() == burst.size() + 100);
+
+	size_t framed(0);
+	while (reader.try_frame(out, error) && out == sent[framed])
+		++framed;
+	CHECK(framed == sent.size() && error.empty());
+
+	CHECK(pair.put(big.substr(100)) && reader.fill() == big.size() - 100);	// read in full, so room was made
+	CHECK(reader.try_frame(out, error) && out == big);
+	CHECK(!reader.try_frame(out, error) && error.empty());
+}
+
+//-----------------------------------------------------------------------------------------
+/// The reader delivers complete messages to the session, keeps a partial one when the peer closes, and reports the
+/// closed connection as a socket error.
+void test_reader_eof()
+{
+	SocketPair pair;
+	Recorder session;
+	TestReader reader(pair._sock, session);
+	const f8String msg(make_news(1, 30)), msg2(make_news(2, 30));
+
+	CHECK(pair.put(msg + msg2.substr(0, 20)));
+	CHECK(reader.on_readable());
+	CHECK(session._received.size() == 1 && session._received[0] == msg);
+	pair.close_far();
+	CHECK(!reader.on_readable());
+	CHECK(reader.is_socket_error());
+	CHECK(session._received.size() == 1);
+
+	bool thrown(false);
+	try { reader.fill(); } catch (PeerResetConnection&) { thrown = true; }
+	CHECK(thrown);
+}
+
+/// Writer with its batching exposed.
+struct TestWriter : public FIXWriter
+{
+	TestWriter(Poco::Net::StreamSocket *sock, Session& session) : FIXWriter(sock, session) {}
+
+	enum { max_batch = _max_batch, wbuf_sz = _wbuf_sz };
+
+	using FIXWriter::batch;
+	using FIXWriter::flush;
+
+	/*! Batch a frame.
+	  \param frame encoded frame
+	  \return true if it was all accepted */
+	bool add(const f8String& frame) { return batch(frame.data(), frame.size()) == static_cast<int>(frame.size()); }
+};
+
+//-----------------------------------------------------------------------------------------
+/// Batched frames are sent back to back, byte exact and in order, with a write whenever the frame or buffer cap
+/// would be exceeded; a frame bigger than the buffer is sent on its own after what was batched before it.
+void test_writer_batching()
+{
+	SocketPair pair;
+	Recorder session;
+	TestWriter writer(pair._sock, session);
+
+	CHECK(writer.flush() == 0 && writer.get_writes() == 0);	// nothing batched
+
+	// a burst of small frames is cut into writes of max_batch frames
+	const unsigned burst(3 * TestWriter::max_batch + 8);
+	f8String sent;
+	size_t capped(0);
+	bool accepted(true);
+	for (unsigned ii(0); ii < burst; ++ii)
+	{
+		const f8String frame(make_news(ii, ii % 50));
+		if (ii == 3 * TestWriter::max_batch)
+			capped = sent.size();
+		sent += frame;
+		accepted &= writer.add(frame);
+	}
+	CHECK(accepted);
+	CHECK(writer.get_writes() == 3 && writer.get_frames_written() == 3 * TestWriter::max_batch);
+	CHECK(writer.flush() == sent.size() - capped);
+	CHECK(writer.get_writes() == 4 && writer.get_frames_written() == burst);
+	CHECK(writer.get_max_frames_written() == TestWriter::max_batch);
+	CHECK(pair.get(sent.size()) == sent);
+	CHECK(pair.drained());
+
+	// large frames are cut into writes of as many as fit in the buffer
+	const f8String large1(make_news(1, MAX_MSG_LENGTH - 500)), large2(make_news(2, MAX_MSG_LENGTH - 500));
+	const unsigned fit(TestWriter::wbuf_sz / large1.size());
+	sent.clear();
+	for (unsigned ii(0); ii <= fit; ++ii)
+	{
+		const f8String& frame(ii % 2 ? large2 : large1);
+		sent += frame;
+		accepted &= writer.add(frame);
+	}
+	CHECK(accepted);
+	CHECK(writer.get_writes() == 5 && writer.get_frames_written() == burst + fit);
+	CHECK(pair.get(fit * large1.size()) == sent.substr(0, fit * large1.size()));
+	CHECK(writer.flush() == large1.size());
+	CHECK(pair.get(large1.size()) == sent.substr(fit * large1.size()));
+	CHECK(pair.drained());
+
+	// an oversize frame is sent on its own, after the frames batched ahead of it
+	const f8String small(make_news(3, 10));
+	f8String oversize;
+	while (oversize.size() <= TestWriter::wbuf_sz)
+		oversize += large1;
+	CHECK(writer.add(small));
+	CHECK(writer.add(oversize));
+	CHECK(writer.get_writes() == 7 && writer.get_max_frames_written() == TestWriter::max_batch);
+	CHECK(pair.get(small.size()) == small);
+	CHECK(pair.get(oversize.size()) == oversize);
+	CHECK(writer.flush() == 0);
+	CHECK(pair.drained());
+}
+
+/// Reads the far end of a socket pair slowly, so that the writer fills its send buffer.
+struct SlowReader
+{
+	SocketPair& _pair;
+	size_t _want;
+	f8String _got;
+
+	SlowReader(SocketPair& pair, const size_t want) : _pair(pair), _want(want) {}
+
+	int operator()()
+	{
+		while (_got.size() < _want)
+		{
+			hypersleep<h_microseconds>(200);
+			const f8String got(_pair.get(min(_want - _got.size(), static_cast<size_t>(1777))));
+			if (got.empty())
+				break;
+			_got += got;
+		}
+		return 0;
+	}
+};
+
+//-----------------------------------------------------------------------------------------
+/// A gather write that the socket only partly accepts is resumed from the first unsent byte, part way into a frame.
+void test_writer_partial()
+{
+	SocketPair pair;
+	Recorder session;
+	TestWriter writer(pair._sock, session);
+
+	int sndbuf(4096);
+	CHECK(setsockopt(pair._fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) == 0);
+	socklen_t len(sizeof(sndbuf));
+	CHECK(getsockopt(pair._fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, &len) == 0);
+	CHECK(fcntl(pair._fds[0], F_SETFL, fcntl(pair._fds[0], F_GETFL) | O_NONBLOCK) == 0);	// sendmsg returns short
+
+	f8String sent;
+	bool accepted(true);
+	for (unsigned ii(0); ii < 40; ++ii)
+	{
+		const f8String frame(make_news(ii, 100 + ii * 37));
+		sent += frame;
+		accepted &= writer.add(frame);
+	}
+	CHECK(accepted);
+	CHECK(sent.size() > 2 * static_cast<size_t>(sndbuf));	// cannot go in one sendmsg
+
+	SlowReader reader(pair, sent.size());
+	dthread<SlowReader> thread(ref(reader));
+	CHECK(thread.start() == 0);
+	CHECK(writer.flush() == sent.size());
+	::shutdown(pair._fds[0], SHUT_WR);	// the reader stops at EOF if anything went missing
+	thread.join();
+	CHECK(writer.get_writes() == 1 && writer.get_frames_written() == 40);
+	CHECK(reader._got == sent);
+	CHECK(pair.drained());
+}
+
+//-----------------------------------------------------------------------------------------
+/// Reactor handler that reads its end of a socket pair and records how it was called.
+struct Counter : public ReactorHandler
+{
+	Reactor& _reactor;
+	int _fd;
+	unsigned _read_us, _tick_us, _remove_after;
+	volatile int _inside;
+	volatile bool _overlapped, _reading, _ticking;
+	volatile unsigned _reads, _eofs, _ticks;
+	volatile size_t _bytes;
+	Tickval _last_read, _tick_end;
+	vector<Tickval> _tick_times;
+
+	Counter(Reactor& reactor, const int fd) : _reactor(reactor), _fd(fd), _read_us(), _tick_us(), _remove_after(),
+		_inside(), _overlapped(), _reading(), _ticking(), _reads(), _eofs(), _ticks(), _bytes() {}
+
+	void enter()
+	{
+		if (__sync_fetch_and_add(&_inside, 1))
+			_overlapped = true;
+	}
+
+	void leave() { __sync_fetch_and_sub(&_inside, 1); }
+
+	bool on_readable()
+	{
+		enter();
+		_reading = true;
+		char buf[1024];
+		const ssize_t got(::read(_fd, buf, sizeof(buf)));
+		if (_read_us)
+			hypersleep<h_microseconds>(_read_us);
+		if (got > 0)
+		{
+			_bytes += got;
+			_last_read.now();
+			if (++_reads == _remove_after)
+				_reactor.remove(this);
+		}
+		else
+			++_eofs;
+		_reading = false;
+		leave();
+		return got > 0;
+	}
+
+	void on_tick()
+	{
+		enter();
+		_ticking = true;
+		_tick_times.push_back(Tickval(true));
+		++_ticks;
+		if (_tick_us)
+			hypersleep<h_microseconds>(_tick_us);
+		_tick_end.now();
+		_ticking = false;
+		leave();
+	}
+};
+
+/*! Wait up to 5s for a count to reach a value.
+  \param what count to watch
+  \param until value to wait for
+  \return true if the value was reached */
+template<typename T>
+bool wait_for(const volatile T& what, const T until)
+{
+	for (unsigned ms(0); what < until && ms < 5000; ++ms)
+		hypersleep<h_milliseconds>(1);
+	return what >= until;
+}
+
+//-----------------------------------------------------------------------------------------
+/// With several reactor threads and frequent ticks, no handler is ever dispatched on two threads at once and
+/// every byte written is read.
+void test_reactor_exclusive()
+{
+	Reactor reactor;
+	CHECK(reactor.configure(4, 1));
+
+	const unsigned handlers(8), writes(2000);
+	vector<SocketPair *> pairs;
+	vector<Counter *> counters;
+	for (unsigned ii(0); ii < handlers; ++ii)
+	{
+		pairs.push_back(new SocketPair);
+		counters.push_back(new Counter(reactor, pairs.back()->_fds[0]));
+		counters.back()->_read_us = counters.back()->_tick_us = 50;
+		CHECK(reactor.add(pairs.back()->_fds[0], counters.back()));
+	}
+	CHECK(reactor.size() == handlers);
+	CHECK(!reactor.configure(2, 10));	// threads already running
+
+	for (unsigned ii(0); ii < writes; ++ii)
+	{
+		pairs[ii % handlers]->put("x");
+		if (ii % 100 == 99)
+			hypersleep<h_milliseconds>(2);
+	}
+
+	bool overlapped(false), ticked(true);
+	size_t bytes(0);
+	for (unsigned ii(0); ii < handlers; ++ii)
+	{
+		wait_for(counters[ii]->_bytes, static_cast<size_t>(writes / handlers));
+		bytes += counters[ii]->_bytes;
+		CHECK(reactor.remove(counters[ii]));
+		overlapped |= counters[ii]->_overlapped;
+		ticked &= counters[ii]->_ticks > 0;
+		delete counters[ii];
+		delete pairs[ii];
+	}
+	CHECK(bytes == writes);
+	CHECK(!overlapped);
+	CHECK(ticked);
+	CHECK(reactor.size() == 0);
+}
+
+//-----------------------------------------------------------------------------------------
+/// A handler may remove itself from on_readable, and may be removed from another thread while it is being
+/// dispatched, in which case remove() waits for the dispatch to finish. Neither is dispatched again.
+void test_reactor_remove()
+{
+	Reactor reactor;
+	CHECK(reactor.configure(2, 10));
+
+	SocketPair self_pair;
+	Counter self(reactor, self_pair._fds[0]);
+	self._remove_after = 3;
+	CHECK(reactor.add(self_pair._fds[0], &self));
+	for (unsigned ii(0); ii < 3; ++ii)
+	{
+		self_pair.put("x");
+		hypersleep<h_milliseconds>(5);
+	}
+	CHECK(wait_for(self._reads, 3U));
+	for (unsigned ms(0); reactor.size() && ms < 5000; ++ms)
+		hypersleep<h_milliseconds>(1);
+	CHECK(reactor.size() == 0);
+	CHECK(!reactor.remove(&self));	// already gone
+	self_pair.put("xx");
+	hypersleep<h_milliseconds>(50);
+	CHECK(self._reads == 3);
+
+	SocketPair busy_pair;
+	Counter busy(reactor, busy_pair._fds[0]);
+	busy._read_us = 50000;
+	CHECK(reactor.add(busy_pair._fds[0], &busy));
+	busy_pair.put("x");
+	for (unsigned ms(0); !busy._reading && ms < 5000; ++ms)
+		hypersleep<h_microseconds>(100);
+	CHECK(busy._reading);
+	CHECK(reactor.remove(&busy));
+	CHECK(!busy._reading && busy._reads == 1);	// remove() returned only once on_readable had
+	CHECK(reactor.size() == 0);
+	busy_pair.put("x");
+	hypersleep<h_milliseconds>(50);
+	CHECK(busy._reads == 1);
+}
+
+//-----------------------------------------------------------------------------------------
+/// Handlers are ticked once per tick interval, and a descriptor that becomes readable while its handler is being
+/// ticked is dispatched once the tick has finished.
+void test_reactor_ticks()
+{
+	Reactor reactor;
+	const unsigned tick_ms(20);
+	CHECK(reactor.configure(2, tick_ms));
+
+	SocketPair pair;
+	Counter counter(reactor, pair._fds[0]);
+	CHECK(reactor.add(pair._fds[0], &counter));
+	hypersleep<h_milliseconds>(25 * tick_ms);
+	CHECK(reactor.remove(&counter));
+	const unsigned ticks(counter._ticks);
+	CHECK(ticks >= 10 && ticks <= 26);
+	Tickval::ticks shortest(Tickval::billion);
+	for (unsigned ii(1); ii < counter._tick_times.size(); ++ii)
+		shortest = min(shortest, (counter._tick_times[ii] - counter._tick_times[ii - 1]).get_ticks());
+	if (_verbose)
+		cout << ticks << " ticks, shortest interval " << shortest / Tickval::thousand << "us" << endl;
+	CHECK(shortest >= tick_ms * Tickval::million / 2);
+
+	Counter slow(reactor, pair._fds[0]);
+	slow._tick_us = 50000;
+	CHECK(reactor.add(pair._fds[0], &slow));
+	for (unsigned ms(0); !slow._ticking && ms < 5000; ++ms)
+		hypersleep<h_microseconds>(100);
+	CHECK(slow._ticking);
+	pair.put("x");	// readable mid tick
+	CHECK(wait_for(slow._reads, 1U));
+	CHECK(!(slow._last_read < slow._tick_end));
+	CHECK(!slow._overlapped);
+	CHECK(reactor.remove(&slow));
+}
+
+//-----------------------------------------------------------------------------------------
+/// A handler that returns false on end of file is deregistered.
+void test_reactor_eof()
+{
+	Reactor reactor;
+	CHECK(reactor.configure(1, 10));
+
+	SocketPair pair;
+	Counter counter(reactor, pair._fds[0]);
+	CHECK(reactor.add(pair._fds[0], &counter));
+	CHECK(!reactor.add(pair._fds[0], &counter));	// already registered
+	pair.put("0123456789");
+	CHECK(wait_for(counter._bytes, static_cast<size_t>(10)));
+	pair.close_far();
+	CHECK(wait_for(counter._eofs, 1U));
+	for (unsigned ms(0); reactor.size() && ms < 5000; ++ms)
+		hypersleep<h_milliseconds>(1);
+	CHECK(reactor.size() == 0);
+	CHECK(counter._eofs == 1 && counter._bytes == 10);
+	CHECK(!reactor.remove(&counter));
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	_verbose = argc > 1 && (strcmp(argv[1], "-v") == 0 || strcmp(argv[1], "--verbose") == 0);
+	GlobalLogger::set_global_filename("runtimetest.log");
+
+	try
+	{
+		test_parse_cpus();
+#if defined __linux__
+		test_thread_affinity();
+#endif
+		test_wait_strategies();
+		test_reader_framing();
+		test_reader_errors();
+		test_reader_compaction();
+		test_reader_eof();
+		test_writer_batching();
+		test_writer_partial();
+		test_reactor_exclusive();
+		test_reactor_remove();
+		test_reactor_ticks();
+		test_reactor_eof();
+	}
+	catch (f8Exception& e)
+	{
+		++_failures;
+		cerr << "exception: " << e.what() << endl;
+	}
+
+	cout << _checks << " checks, " << _failures << " failed" << endl;
+	return _failures ? 1 : 0;
+}
+